@@ -0,0 +1,123 @@
+// Host benchmark: plays millions of simulated games through the headless
+// core and reports throughput and per-event cost.
+//
+//   ./bench [-n games] [-s seed] [-e error_per_mille] [-m max_ns_per_press] [-E] [-l latency_ms] [-t]
+//
+// -E plays endless mode instead of classic. -l makes every timer expiry run
+// up to latency_ms late, to check that playback edges don't drift. -t dumps
+// the trace ring (the last events of the run) to stdout.
+//
+// With -m the run fails (exit 1) when the measured cost per press exceeds
+// the budget, so it can gate regressions before they reach a watch.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "trace.h"
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void print_trace_record(const TraceRecord *record, void *context) {
+  printf("  %10lu %-10s %3d %6d\n", (unsigned long)record->t_ms, trace_event_name(record->event),
+         record->a, record->b);
+}
+
+int main(int argc, char **argv) {
+  unsigned long games = 1000000;
+  unsigned long seed = 1;
+  double max_ns_per_press = 0;
+  GameMode mode = GAME_MODE_CLASSIC;
+  unsigned long latency_ms = 0;
+  int dump_trace = 0;
+  SimPlayer player = {
+    .error_per_mille = 60,
+    .reaction_min_ms = 250,
+    .reaction_span_ms = 300,
+    .anticipate_per_mille = 100,
+  };
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:e:m:El:t")) != -1) {
+    switch (opt) {
+      case 'n': games = strtoul(optarg, NULL, 10); break;
+      case 's': seed = strtoul(optarg, NULL, 10); break;
+      case 'e': player.error_per_mille = (uint32_t)strtoul(optarg, NULL, 10); break;
+      case 'm': max_ns_per_press = strtod(optarg, NULL); break;
+      case 'E': mode = GAME_MODE_ENDLESS; break;
+      case 'l': latency_ms = strtoul(optarg, NULL, 10); break;
+      case 't': dump_trace = 1; break;
+      default:
+        fprintf(stderr, "usage: %s [-n games] [-s seed] [-e error_per_mille] [-m max_ns_per_press] [-E] [-l latency_ms] [-t]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  sim_init((uint32_t)seed);
+  game_set_mode(mode);
+  sim_set_timer_latency((uint32_t)latency_ms);
+  double start = now_seconds();
+  for (unsigned long i = 0; i < games; ++i) {
+    sim_play_game(&player);
+  }
+  double elapsed = now_seconds() - start;
+
+  const SimStats *stats = sim_get_stats();
+  uint64_t events = stats->presses + stats->timer_fires;
+  double ns_per_event = events ? elapsed * 1e9 / events : 0;
+  double ns_per_press = stats->presses ? elapsed * 1e9 / stats->presses : 0;
+
+  printf("games          %llu (%llu wins, %llu stuck)\n",
+         (unsigned long long)stats->games, (unsigned long long)stats->wins,
+         (unsigned long long)stats->stuck);
+  printf("mode           %s\n", mode == GAME_MODE_ENDLESS ? "endless" : "classic");
+  printf("avg round      %.2f\n", stats->games ? (double)stats->rounds / stats->games : 0.0);
+  printf("presses        %llu\n", (unsigned long long)stats->presses);
+  printf("timer fires    %llu (%llu wakeups, %.2f per round)\n", (unsigned long long)stats->timer_fires,
+         (unsigned long long)stats->wakeups, stats->rounds ? (double)stats->wakeups / stats->rounds : 0.0);
+  printf("ui calls       %llu (%.2f per event)\n", (unsigned long long)stats->ui_calls,
+         events ? (double)stats->ui_calls / events : 0.0);
+  const GameTiming *timing = game_get_timing();
+  printf("edge error     %.2f ms mean |err|, %ld ms max late, %.1f%% late\n",
+         timing->edges ? (double)timing->total_abs_error_ms / timing->edges : 0.0,
+         (long)timing->max_error_ms,
+         timing->edges ? 100.0 * timing->late_edges / timing->edges : 0.0);
+  const GameInputStats *input = game_get_input_stats();
+  printf("type-ahead     %llu queued, %llu replayed, %llu dropped\n",
+         (unsigned long long)input->queued, (unsigned long long)input->replayed,
+         (unsigned long long)input->dropped);
+  const Histogram *reaction = game_get_reaction_histogram();
+  const Histogram *round = game_get_round_histogram();
+  printf("reaction       p50 %lu ms, p95 %lu ms, mean %lu ms\n",
+         (unsigned long)histogram_percentile(reaction, 50), (unsigned long)histogram_percentile(reaction, 95),
+         (unsigned long)histogram_mean(reaction));
+  printf("round time     p50 %lu ms, p95 %lu ms, mean %lu ms\n",
+         (unsigned long)histogram_percentile(round, 50), (unsigned long)histogram_percentile(round, 95),
+         (unsigned long)histogram_mean(round));
+  printf("simulated time %.1f h\n", stats->sim_ms / 3600000.0);
+  printf("wall time      %.3f s\n", elapsed);
+  printf("throughput     %.0f games/s, %.0f events/s\n", games / elapsed, events / elapsed);
+  printf("cost           %.1f ns/event, %.1f ns/press\n", ns_per_event, ns_per_press);
+  if (dump_trace) {
+    printf("trace          %d records (%lu overwritten)\n", trace_count(), (unsigned long)trace_dropped());
+    trace_dump(print_trace_record, NULL);
+  }
+
+  if (stats->stuck) {
+    fprintf(stderr, "FAIL: %llu games stalled with no pending timer\n", (unsigned long long)stats->stuck);
+    return 1;
+  }
+  if (max_ns_per_press > 0 && ns_per_press > max_ns_per_press) {
+    fprintf(stderr, "FAIL: %.1f ns/press exceeds budget of %.1f\n", ns_per_press, max_ns_per_press);
+    return 1;
+  }
+  return 0;
+}
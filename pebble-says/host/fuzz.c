@@ -0,0 +1,340 @@
+// Host fuzzer: drives the headless core with random event sequences
+// (presses, Select, clock jumps, focus changes, mode switches) and checks
+// the state machine's invariants after every event.
+//
+//   ./fuzz [-n events] [-s seed] [-c correct_per_mille]
+//
+// -c is the chance that a press is the expected step, so runs reach long
+// rounds instead of ending on the first wrong guess. On a violation the
+// last events are printed and the run exits 1; the seed reproduces it.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "game_core.h"
+#include "scheduler.h"
+#include "trace.h"
+
+#define FUZZ_NEVER UINT64_MAX
+#define FUZZ_HISTORY 16
+
+typedef enum {
+  FUZZ_EV_ADVANCE,  // let 0-400 ms pass, firing whatever falls due
+  FUZZ_EV_NEXT,     // jump straight to the next deadline
+  FUZZ_EV_PRESS,
+  FUZZ_EV_SELECT,
+  FUZZ_EV_FOCUS,    // toggle focus
+  FUZZ_EV_MODE,
+  FUZZ_EV_COUNT
+} FuzzEvent;
+
+static const char *const s_event_names[FUZZ_EV_COUNT] = {
+  [FUZZ_EV_ADVANCE] = "advance",
+  [FUZZ_EV_NEXT] = "next",
+  [FUZZ_EV_PRESS] = "press",
+  [FUZZ_EV_SELECT] = "select",
+  [FUZZ_EV_FOCUS] = "focus",
+  [FUZZ_EV_MODE] = "mode",
+};
+
+// cumulative weights out of 100
+static const uint8_t s_event_weights[FUZZ_EV_COUNT] = {
+  [FUZZ_EV_ADVANCE] = 30,
+  [FUZZ_EV_NEXT] = 55,
+  [FUZZ_EV_PRESS] = 88,
+  [FUZZ_EV_SELECT] = 95,
+  [FUZZ_EV_FOCUS] = 99,
+  [FUZZ_EV_MODE] = 100,
+};
+
+typedef struct {
+  uint64_t at_ms;
+  uint8_t event;
+  int8_t arg;
+  uint8_t phase;  // before the event
+} FuzzRecord;
+
+static uint64_t s_now_ms;
+static uint64_t s_armed_at = FUZZ_NEVER;
+static SchedulerHandle s_game_timers[GAME_TIMER_COUNT];
+static uint32_t s_rng;
+static bool s_lit[3];
+static bool s_celebrating;
+static bool s_focused = true;
+static uint64_t s_events;
+static uint64_t s_games;
+static uint64_t s_wakeups;
+static uint64_t s_presses_while_busy;
+static int s_longest;
+static FuzzRecord s_history[FUZZ_HISTORY];
+static int s_history_head;
+static int s_history_count;
+
+static uint32_t fuzz_rand(void) {
+  uint32_t x = s_rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return s_rng = x;
+}
+
+static uint32_t fuzz_now_ms(void) {
+  return (uint32_t)s_now_ms;
+}
+
+static void fuzz_arm(uint32_t delay_ms) {
+  s_armed_at = s_now_ms + delay_ms;
+}
+
+static void fuzz_disarm(void) {
+  s_armed_at = FUZZ_NEVER;
+}
+
+static const SchedulerBackend s_sched_backend = {
+  .now_ms = fuzz_now_ms,
+  .arm = fuzz_arm,
+  .disarm = fuzz_disarm,
+};
+
+static void game_timer_callback(void *data) {
+  game_timer_fired((GameTimer)(intptr_t)data);
+}
+
+static void fuzz_schedule_timer(GameTimer timer, uint32_t ms) {
+  s_game_timers[timer] = scheduler_add(ms, game_timer_callback, (void*)(intptr_t)timer);
+}
+
+static void fuzz_cancel_timer(GameTimer timer) {
+  scheduler_cancel(&s_game_timers[timer]);
+}
+
+static void fuzz_show_message(const char *msg) {}
+static void fuzz_highlight_glyph(int idx, bool on) { s_lit[idx] = on; }
+static void fuzz_update_info(void) {}
+static void fuzz_apply_layout(void) {}
+static void fuzz_vibe(GameVibe vibe) {}
+static void fuzz_start_celebration(int cycles) { s_celebrating = true; }
+static void fuzz_stop_celebration(void) { s_celebrating = false; }
+static void fuzz_game_finished(bool won) {}
+
+static const GamePlatform s_platform = {
+  .show_message = fuzz_show_message,
+  .highlight_glyph = fuzz_highlight_glyph,
+  .update_info = fuzz_update_info,
+  .apply_layout = fuzz_apply_layout,
+  .vibe = fuzz_vibe,
+  .start_celebration = fuzz_start_celebration,
+  .stop_celebration = fuzz_stop_celebration,
+  .schedule_timer = fuzz_schedule_timer,
+  .cancel_timer = fuzz_cancel_timer,
+  .now_ms = fuzz_now_ms,
+  .game_finished = fuzz_game_finished,
+};
+
+static const char *phase_name(int phase) {
+  switch (phase) {
+    case GAME_PHASE_OVER: return "over";
+    case GAME_PHASE_GAP: return "gap";
+    case GAME_PHASE_SHOW: return "show";
+    case GAME_PHASE_INPUT: return "input";
+    case GAME_PHASE_TRANSITION: return "transition";
+    default: return "?";
+  }
+}
+
+static void fail(const char *what, unsigned long seed) {
+  const GameState *game = game_get_state();
+  fprintf(stderr, "FAIL after %llu events (seed %lu): %s\n", (unsigned long long)s_events, seed, what);
+  fprintf(stderr, "  phase %s, seq_len %d, show_index %d, input_index %d, lit %d%d%d, focused %d\n",
+          phase_name(game->phase), game->seq_len, game->show_index, game->input_index,
+          s_lit[0], s_lit[1], s_lit[2], s_focused);
+  for (int i = FUZZ_HISTORY - s_history_count; i < FUZZ_HISTORY; ++i) {
+    const FuzzRecord *record = &s_history[(s_history_head + i) % FUZZ_HISTORY];
+    fprintf(stderr, "  %10llu %-8s %3d  (%s)\n", (unsigned long long)record->at_ms,
+            s_event_names[record->event], record->arg, phase_name(record->phase));
+  }
+  exit(1);
+}
+
+static bool pending(GameTimer timer) {
+  return scheduler_is_pending(s_game_timers[timer]);
+}
+
+// Returns the first invariant the current state breaks, or NULL.
+static const char *check_invariants(void) {
+  const GameState *game = game_get_state();
+  int timers = 0;
+  for (int i = 0; i < GAME_TIMER_COUNT; ++i) timers += pending((GameTimer)i);
+  if (scheduler_pending_count() != timers) return "scheduler holds an entry no game timer owns";
+  if (!s_focused && s_armed_at != FUZZ_NEVER) return "backing timer armed while unfocused";
+  if (game->phase < 0 || game->phase >= GAME_PHASE_COUNT) return "phase out of range";
+  // a finished game may be longer than the mode picked since
+  if (!game_is_over(game) && game->seq_len > game_max_sequence(game->mode)) {
+    return "sequence past the mode's maximum";
+  }
+  if (s_celebrating != (game->phase == GAME_PHASE_TRANSITION)) return "celebration outside the transition";
+  if (pending(GAME_TIMER_TRANSITION) != (game->phase == GAME_PHASE_TRANSITION)) {
+    return "transition timer and phase disagree";
+  }
+  if (pending(GAME_TIMER_FEEDBACK) && game->phase != GAME_PHASE_INPUT) return "stray feedback timer";
+  bool showing = game_is_showing(game);
+  if (pending(GAME_TIMER_SEQUENCE) != (showing && s_focused)) return "playback timer and phase disagree";
+  switch (game->phase) {
+    case GAME_PHASE_GAP:
+      if (game->show_index > game->seq_len) return "gap past the end of the sequence";
+      break;
+    case GAME_PHASE_SHOW: {
+      if (game->show_index >= game->seq_len) return "showing past the end of the sequence";
+      int step = game_sequence_step(game->show_index);
+      for (int i = 0; i < 3; ++i) {
+        if (s_lit[i] != (i == step)) return "lit glyphs don't match the step shown";
+      }
+      break;
+    }
+    case GAME_PHASE_INPUT:
+      if (game->input_index >= game->seq_len) return "input index past the sequence";
+      break;
+    default:
+      break;
+  }
+  return NULL;
+}
+
+static void check(unsigned long seed) {
+  const char *broken = check_invariants();
+  if (broken) fail(broken, seed);
+}
+
+// Fires due wakeups one at a time, checking after each, up to time t.
+static void run_until(uint64_t t, unsigned long seed) {
+  while (s_armed_at != FUZZ_NEVER && s_armed_at <= t) {
+    s_now_ms = s_armed_at;
+    s_armed_at = FUZZ_NEVER;
+    s_wakeups++;
+    scheduler_dispatch();
+    check(seed);
+  }
+  if (t != FUZZ_NEVER && t > s_now_ms) s_now_ms = t;
+}
+
+static void press(SequenceButton button, unsigned long seed) {
+  const GameState *game = game_get_state();
+  GamePhase before = game->phase;
+  int index = game->input_index;
+  uint32_t reactions = game_get_reaction_histogram()->total;
+  game_press(button);
+  if (before != GAME_PHASE_INPUT) {
+    // input never counts outside the prompt; at most it is queued
+    s_presses_while_busy++;
+    if (game->input_index != index || game_get_reaction_histogram()->total != reactions) {
+      fail("press accepted outside GAME_PHASE_INPUT", seed);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  unsigned long events = 10000000;
+  unsigned long seed = 1;
+  uint32_t correct_per_mille = 800;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:c:")) != -1) {
+    switch (opt) {
+      case 'n': events = strtoul(optarg, NULL, 10); break;
+      case 's': seed = strtoul(optarg, NULL, 10); break;
+      case 'c': correct_per_mille = (uint32_t)strtoul(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "usage: %s [-n events] [-s seed] [-c correct_per_mille]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  s_rng = seed ? (uint32_t)seed : 1;
+  scheduler_init(&s_sched_backend);
+  trace_init(fuzz_now_ms);
+  game_init(&s_platform);
+  game_seed((uint32_t)seed);
+  const GameState *game = game_get_state();
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (s_events = 0; s_events < events; ++s_events) {
+    uint32_t roll = fuzz_rand() % 100;
+    FuzzEvent event = FUZZ_EV_ADVANCE;
+    while (roll >= s_event_weights[event]) event++;
+    // buttons and Select aren't delivered while a modal covers the app
+    if (!s_focused && (event == FUZZ_EV_PRESS || event == FUZZ_EV_SELECT)) event = FUZZ_EV_FOCUS;
+
+    FuzzRecord *record = &s_history[s_history_head];
+    s_history_head = (s_history_head + 1) % FUZZ_HISTORY;
+    if (s_history_count < FUZZ_HISTORY) s_history_count++;
+    *record = (FuzzRecord) { .at_ms = s_now_ms, .event = event, .phase = game->phase };
+
+    switch (event) {
+      case FUZZ_EV_ADVANCE: {
+        uint32_t delta = fuzz_rand() % 401;
+        record->arg = (int8_t)(delta / 4);
+        run_until(s_now_ms + delta, seed);
+        break;
+      }
+      case FUZZ_EV_NEXT:
+        // while unfocused nothing is armed, so this just lets time pass
+        run_until(s_armed_at != FUZZ_NEVER ? s_armed_at : s_now_ms + 1000, seed);
+        break;
+      case FUZZ_EV_PRESS: {
+        int expected = game->phase == GAME_PHASE_INPUT ? game_sequence_step(game->input_index) : -1;
+        int button = expected >= 0 && fuzz_rand() % 1000 < correct_per_mille ? expected : (int)(fuzz_rand() % 3);
+        record->arg = (int8_t)button;
+        press((SequenceButton)button, seed);
+        break;
+      }
+      case FUZZ_EV_SELECT:
+        if (game_is_over(game)) {
+          s_games++;
+          game_select();
+        } else {
+          press(SEQ_BTN_SELECT, seed);
+        }
+        break;
+      case FUZZ_EV_FOCUS:
+        // same order as the watch: the core first, then the timers
+        record->arg = !s_focused;
+        if (s_focused) {
+          s_focused = false;
+          game_focus_lost();
+          scheduler_pause();
+        } else {
+          s_focused = true;
+          scheduler_resume();
+          game_focus_regained();
+        }
+        break;
+      case FUZZ_EV_MODE:
+        game_set_mode(game->mode == GAME_MODE_ENDLESS ? GAME_MODE_CLASSIC : GAME_MODE_ENDLESS);
+        break;
+      default:
+        break;
+    }
+    check(seed);
+    if (game->seq_len > s_longest) s_longest = game->seq_len;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+  printf("events         %lu (%llu wakeups)\n", events, (unsigned long long)s_wakeups);
+  printf("games          %llu, longest sequence %d\n", (unsigned long long)s_games, s_longest);
+  const GameInputStats *input = game_get_input_stats();
+  printf("busy presses   %llu (%lu queued, %lu replayed, %lu dropped)\n",
+         (unsigned long long)s_presses_while_busy, (unsigned long)input->queued,
+         (unsigned long)input->replayed, (unsigned long)input->dropped);
+  printf("simulated time %.1f h\n", s_now_ms / 3600000.0);
+  printf("wall time      %.3f s\n", elapsed);
+  printf("throughput     %.0f events/s\n", elapsed > 0 ? events / elapsed : 0.0);
+  printf("ok\n");
+  return 0;
+}
@@ -0,0 +1,207 @@
+// Host replay harness.
+//
+//   ./replay [-n games] [-s seed] [-E]    record simulated games, play each back, compare
+//   ./replay -f dump.txt                  play back a replay from the watch log
+//   ./replay -w [-s seed] [-E]            print one simulated game's replay as hex
+//
+// Without -f every simulated game is recorded by the core, played back on
+// a fresh mocked clock and re-recorded; the two recordings must match byte
+// for byte and end at the same length. The run also reports how many
+// bytes a replay takes.
+//
+// With -f the file holds the hex the watch logs on a long press of Select
+// (the "Replay ..." lines, log prefixes are skipped). The run is played
+// back with a timeline of each event: when it arrived, what the game was
+// doing and, for presses, the expected step and the reaction time.
+//
+// With -w one game is recorded and printed as the watch would log it, for
+// a benchmark build to embed (tools/emu_bench.py).
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim.h"
+
+static const char *phase_name(GamePhase phase) {
+  switch (phase) {
+    case GAME_PHASE_OVER: return "over";
+    case GAME_PHASE_GAP: return "gap";
+    case GAME_PHASE_SHOW: return "show";
+    case GAME_PHASE_INPUT: return "input";
+    case GAME_PHASE_TRANSITION: return "transition";
+    default: return "?";
+  }
+}
+
+static const char *code_name(const ReplayEvent *event) {
+  switch (event->code) {
+    case REPLAY_CODE_UP: return "Up";
+    case REPLAY_CODE_SELECT: return "Select";
+    case REPLAY_CODE_DOWN: return "Down";
+    default: return event->ext == REPLAY_EXT_FOCUS_LOST ? "focus-" : "focus+";
+  }
+}
+
+// delta is the time since the previous event: for the presses of a round
+// after the first, the reaction time
+static void print_event(const ReplayEvent *event, void *context) {
+  const GameState *game = game_get_state();
+  printf("%8lu ms  +%-6lu %-7s %-10s", (unsigned long)event->at_ms, (unsigned long)event->delta_ms,
+         code_name(event), phase_name(game->phase));
+  if (event->code != REPLAY_CODE_EXT && game->phase == GAME_PHASE_INPUT) {
+    int expected = game_sequence_step(game->input_index);
+    printf(" round %d step %d/%d expected %-6s %s", game->round, game->input_index + 1, game->seq_len,
+           game_button_name(expected), expected == event->code ? "ok" : "WRONG");
+  } else if (event->code != REPLAY_CODE_EXT) {
+    printf(" queued (round %d)", game->round);
+  }
+  printf("\n");
+}
+
+static int hex_value(int c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  c = tolower(c);
+  return c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+}
+
+// Collects the hex after every "Replay " in the file.
+static bool load_dump(const char *path, Replay *out) {
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    perror(path);
+    return false;
+  }
+  memset(out, 0, sizeof(*out));
+  uint8_t *bytes = (uint8_t *)out;
+  size_t size = 0;
+  char line[512];
+  while (fgets(line, sizeof(line), file)) {
+    char *hex = strstr(line, "Replay ");
+    if (!hex) continue;
+    hex += strlen("Replay ");
+    while (hex_value(hex[0]) >= 0 && hex_value(hex[1]) >= 0 && size < sizeof(*out)) {
+      bytes[size++] = (uint8_t)(hex_value(hex[0]) << 4 | hex_value(hex[1]));
+      hex += 2;
+    }
+  }
+  fclose(file);
+  return size >= sizeof(Replay) - REPLAY_ARENA_BYTES && size == replay_size(out);
+}
+
+static int write_game(const SimPlayer *player, uint32_t seed, GameMode mode) {
+  sim_init(seed);
+  game_set_mode(mode);
+  sim_play_game(player);
+  const Replay *replay = replay_get();
+  if (replay->flags & REPLAY_FLAG_TRUNCATED) {
+    fprintf(stderr, "seed %lu: the run outgrew the replay arena\n", (unsigned long)seed);
+    return 1;
+  }
+  const uint8_t *bytes = (const uint8_t *)replay;
+  uint32_t size = replay_size(replay);
+  for (uint32_t off = 0; off < size; off += 32) {
+    printf("Replay ");
+    for (uint32_t i = off; i < size && i < off + 32; ++i) printf("%02x", bytes[i]);
+    printf("\n");
+  }
+  return 0;
+}
+
+static int play_dump(const char *path) {
+  static Replay replay;
+  if (!load_dump(path, &replay) || !replay_valid(&replay)) {
+    fprintf(stderr, "%s: no valid replay found\n", path);
+    return 1;
+  }
+  printf("seed %lu, %s, from length %u, %u events in %u bytes%s\n", (unsigned long)replay.seed,
+         replay.mode == GAME_MODE_ENDLESS ? "endless" : "classic", replay.start_len, replay.events,
+         (unsigned)replay_size(&replay), replay.flags & REPLAY_FLAG_TRUNCATED ? " (truncated)" : "");
+  sim_init(replay.seed);
+  sim_play_replay(&replay, print_event, NULL);
+  const GameState *game = game_get_state();
+  printf("ended at length %d (%s); recorded %s at length %u\n", game->seq_len,
+         game_is_over(game) ? "game over" : "in progress",
+         replay.flags & REPLAY_FLAG_ENDED ? (replay.flags & REPLAY_FLAG_WON ? "won" : "lost") : "unfinished",
+         replay.end_len);
+  if ((replay.flags & REPLAY_FLAG_ENDED) && game->seq_len != replay.end_len) {
+    fprintf(stderr, "FAIL: playback diverged from the recording\n");
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  unsigned long games = 100000;
+  unsigned long seed = 1;
+  GameMode mode = GAME_MODE_CLASSIC;
+  const char *dump = NULL;
+  bool write = false;
+  SimPlayer player = {
+    .error_per_mille = 60,
+    .reaction_min_ms = 250,
+    .reaction_span_ms = 300,
+    .anticipate_per_mille = 100,
+  };
+
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:Ef:w")) != -1) {
+    switch (opt) {
+      case 'n': games = strtoul(optarg, NULL, 10); break;
+      case 's': seed = strtoul(optarg, NULL, 10); break;
+      case 'E': mode = GAME_MODE_ENDLESS; break;
+      case 'f': dump = optarg; break;
+      case 'w': write = true; break;
+      default:
+        fprintf(stderr, "usage: %s [-n games] [-s seed] [-E] | -f dump.txt | -w [-s seed] [-E]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (dump) return play_dump(dump);
+  if (write) return write_game(&player, (uint32_t)seed, mode);
+
+  static Replay recorded;
+  unsigned long mismatches = 0, truncated = 0, played = 0;
+  uint64_t bytes = 0, events = 0;
+  uint32_t max_bytes = 0;
+  sim_init((uint32_t)seed);
+  game_set_mode(mode);
+  for (unsigned long i = 0; i < games; ++i) {
+    sim_play_game(&player);
+    memcpy(&recorded, replay_get(), sizeof(recorded));
+    uint32_t size = replay_size(&recorded);
+    bytes += size;
+    events += recorded.events;
+    if (size > max_bytes) max_bytes = size;
+    if (recorded.flags & REPLAY_FLAG_TRUNCATED) {
+      // a prefix can't be checked against the end of the run
+      truncated++;
+      continue;
+    }
+    played++;
+    if (!sim_play_replay(&recorded, NULL, NULL) || !game_is_over(game_get_state()) ||
+        game_get_state()->seq_len != recorded.end_len ||
+        memcmp(replay_get(), &recorded, replay_size(&recorded)) != 0) {
+      if (!mismatches) fprintf(stderr, "first mismatch: game %lu, seed %lu\n", i, (unsigned long)recorded.seed);
+      mismatches++;
+    }
+    sim_finish_game();
+  }
+
+  printf("games          %lu (%lu played back, %lu truncated)\n", games, played, truncated);
+  printf("mode           %s\n", mode == GAME_MODE_ENDLESS ? "endless" : "classic");
+  printf("replay size    %.1f bytes avg, %lu max (arena %d)\n", games ? (double)bytes / games : 0.0,
+         (unsigned long)max_bytes, REPLAY_ARENA_BYTES);
+  printf("per event      %.2f bytes of data\n",
+         events ? (double)(bytes - games * (sizeof(Replay) - REPLAY_ARENA_BYTES)) / events : 0.0);
+  printf("mismatches     %lu\n", mismatches);
+  if (mismatches) {
+    fprintf(stderr, "FAIL: %lu replays didn't reproduce their run\n", mismatches);
+    return 1;
+  }
+  return 0;
+}
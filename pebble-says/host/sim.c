@@ -0,0 +1,210 @@
+#include "sim.h"
+#include "scheduler.h"
+#include "trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_NEVER UINT64_MAX
+
+static uint64_t s_now_ms;
+static uint64_t s_armed_at = SIM_NEVER; // the scheduler's single backing timer
+static SchedulerHandle s_game_timers[GAME_TIMER_COUNT];
+static uint32_t s_rng;
+static uint32_t s_latency_ms;
+static SimStats s_stats;
+
+// xorshift32 for the player model so it doesn't perturb the game's own RNG
+static uint32_t sim_rand(void) {
+  uint32_t x = s_rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return s_rng = x;
+}
+
+static void sim_show_message(const char *msg) { s_stats.ui_calls++; }
+static void sim_highlight_glyph(int idx, bool on) { s_stats.ui_calls++; }
+static void sim_update_info(void) { s_stats.ui_calls++; }
+static void sim_apply_layout(void) { s_stats.ui_calls++; }
+static void sim_vibe(GameVibe vibe) { s_stats.ui_calls++; }
+static void sim_start_celebration(int cycles) { s_stats.ui_calls++; }
+static void sim_stop_celebration(void) { s_stats.ui_calls++; }
+
+static uint32_t sim_now_ms(void) {
+  return (uint32_t)s_now_ms;
+}
+
+static void sim_arm(uint32_t delay_ms) {
+  s_armed_at = s_now_ms + delay_ms;
+}
+
+static void sim_disarm(void) {
+  s_armed_at = SIM_NEVER;
+}
+
+static const SchedulerBackend s_sched_backend = {
+  .now_ms = sim_now_ms,
+  .arm = sim_arm,
+  .disarm = sim_disarm,
+};
+
+static void game_timer_callback(void *data) {
+  s_stats.timer_fires++;
+  game_timer_fired((GameTimer)(intptr_t)data);
+}
+
+static void sim_schedule_timer(GameTimer timer, uint32_t ms) {
+  s_game_timers[timer] = scheduler_add(ms, game_timer_callback, (void*)(intptr_t)timer);
+}
+
+static void sim_cancel_timer(GameTimer timer) {
+  scheduler_cancel(&s_game_timers[timer]);
+}
+
+void sim_set_timer_latency(uint32_t max_ms) {
+  s_latency_ms = max_ms;
+}
+
+static const GamePlatform s_platform = {
+  .show_message = sim_show_message,
+  .highlight_glyph = sim_highlight_glyph,
+  .update_info = sim_update_info,
+  .apply_layout = sim_apply_layout,
+  .vibe = sim_vibe,
+  .start_celebration = sim_start_celebration,
+  .stop_celebration = sim_stop_celebration,
+  .schedule_timer = sim_schedule_timer,
+  .cancel_timer = sim_cancel_timer,
+  .now_ms = sim_now_ms,
+};
+
+static bool fire_timers_until(uint64_t t) {
+  bool fired = false;
+  while (s_armed_at != SIM_NEVER && s_armed_at <= t) {
+    s_now_ms = s_armed_at + (s_latency_ms ? sim_rand() % (s_latency_ms + 1) : 0);
+    s_armed_at = SIM_NEVER;
+    s_stats.wakeups++;
+    scheduler_dispatch();
+    fired = true;
+  }
+  return fired;
+}
+
+void sim_play_game(const SimPlayer *player) {
+  const GameState *game = game_get_state();
+  uint64_t start_ms = s_now_ms;
+  uint64_t press_at = SIM_NEVER;
+  int anticipated_round = -1;
+
+  game_select();
+  while (!game_is_over(game)) {
+    if (game->phase == GAME_PHASE_INPUT) {
+      if (press_at == SIM_NEVER) {
+        uint32_t jitter = player->reaction_span_ms ? sim_rand() % player->reaction_span_ms : 0;
+        press_at = s_now_ms + player->reaction_min_ms + jitter;
+      }
+      // timers due before the press (glyph clear, "Good" feedback) run first
+      if (fire_timers_until(press_at)) continue;
+      s_now_ms = press_at;
+      press_at = SIM_NEVER;
+      int expected = game_sequence_step(game->input_index);
+      int pressed = expected;
+      if (sim_rand() % 1000 < player->error_per_mille) {
+        pressed = (expected + 1 + sim_rand() % 2) % 3;
+      }
+      s_stats.presses++;
+      game_press((SequenceButton)pressed);
+    } else {
+      press_at = SIM_NEVER;
+      if (s_armed_at == SIM_NEVER) {
+        s_stats.stuck++;
+        break;
+      }
+      // last pause before the prompt: an eager player may answer early
+      if (game->phase == GAME_PHASE_GAP && game->show_index >= game->seq_len && anticipated_round != game->round) {
+        anticipated_round = game->round;
+        if (sim_rand() % 1000 < player->anticipate_per_mille) {
+          // at least 1 ms early, so the press orders before the edge in a replay too
+          uint64_t lead = 1 + sim_rand() % (GAME_TYPEAHEAD_WINDOW_MS - 1);
+          if (s_armed_at - lead > s_now_ms) s_now_ms = s_armed_at - lead;
+          s_stats.presses++;
+          game_press((SequenceButton)game_sequence_step(0));
+        }
+      }
+      fire_timers_until(s_armed_at);
+    }
+  }
+  // let trailing feedback timers drain so the next game starts clean
+  fire_timers_until(SIM_NEVER - 1);
+
+  s_stats.games++;
+  s_stats.rounds += game->round;
+  if (game->input_index == game->seq_len && game->seq_len >= game_max_sequence(game->mode)) s_stats.wins++;
+  s_stats.sim_ms += s_now_ms - start_ms;
+}
+
+bool sim_play_replay(const Replay *replay, void (*on_event)(const ReplayEvent *event, void *context),
+                     void *context) {
+  const GameState *game = game_get_state();
+  if (!game_is_over(game)) return false;
+  uint64_t start_ms = s_now_ms;
+  if (!game_start_replay(replay)) return false;
+  ReplayCursor cursor;
+  ReplayEvent event;
+  replay_cursor_init(&cursor, replay);
+  while (replay_next(&cursor, &event)) {
+    uint64_t at = start_ms + event.at_ms;
+    fire_timers_until(at);
+    if (at > s_now_ms) s_now_ms = at;
+    if (on_event) on_event(&event, context);
+    switch (event.code) {
+      case REPLAY_CODE_UP: game_press(SEQ_BTN_UP); break;
+      case REPLAY_CODE_SELECT: game_select(); break;
+      case REPLAY_CODE_DOWN: game_press(SEQ_BTN_DOWN); break;
+      default:
+        // the watch's order: the core first on the way out, the timers first on the way back
+        if (event.ext == REPLAY_EXT_FOCUS_LOST) {
+          game_focus_lost();
+          scheduler_pause();
+        } else {
+          scheduler_resume();
+          game_focus_regained();
+        }
+        break;
+    }
+    s_stats.presses += event.code != REPLAY_CODE_EXT;
+  }
+  // a recording cut short leaves the game waiting for input; stop there
+  scheduler_resume();
+  game_focus_regained();
+  fire_timers_until(SIM_NEVER - 1);
+  return true;
+}
+
+void sim_finish_game(void) {
+  const GameState *game = game_get_state();
+  while (!game_is_over(game)) {
+    if (game->phase == GAME_PHASE_INPUT) {
+      game_press((SequenceButton)((game_sequence_step(game->input_index) + 1) % 3));
+    } else if (!fire_timers_until(s_armed_at)) {
+      break;
+    }
+  }
+  fire_timers_until(SIM_NEVER - 1);
+}
+
+const SimStats *sim_get_stats(void) {
+  return &s_stats;
+}
+
+void sim_init(uint32_t seed) {
+  s_rng = seed ? seed : 1;
+  s_now_ms = 0;
+  s_armed_at = SIM_NEVER;
+  memset(&s_stats, 0, sizeof(s_stats));
+  scheduler_init(&s_sched_backend);
+  trace_init(sim_now_ms);
+  game_init(&s_platform);
+  game_seed(seed);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Headless GamePlatform for the host harness: a mocked millisecond clock,
+// discrete timer deadlines and a scripted player. No real time passes;
+// the simulation jumps straight to the next deadline or press.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "game_core.h"
+
+typedef struct {
+  uint32_t error_per_mille;  // chance of a wrong press, per press
+  uint32_t reaction_min_ms;  // press delay after the game starts accepting input
+  uint32_t reaction_span_ms; // uniform jitter added on top of reaction_min_ms
+  uint32_t anticipate_per_mille; // chance of pressing the first step just before "Your turn"
+} SimPlayer;
+
+// Worst-case callback latency of the mocked backing timer: each expiry runs
+// up to this many ms late, like an AppTimer behind a slow redraw.
+void sim_set_timer_latency(uint32_t max_ms);
+
+typedef struct {
+  uint64_t games;
+  uint64_t wins;
+  uint64_t rounds;        // sum of rounds reached
+  uint64_t presses;
+  uint64_t timer_fires;   // core timer callbacks
+  uint64_t wakeups;       // backing-timer expiries (one may run several callbacks)
+  uint64_t ui_calls;      // platform callbacks (messages, glyphs, layout, vibes)
+  uint64_t sim_ms;        // total simulated wall-clock time
+  uint64_t stuck;         // games that ran out of events before game over
+} SimStats;
+
+void sim_init(uint32_t seed);
+void sim_play_game(const SimPlayer *player);
+
+// Plays a recorded run back on the mocked clock: timers due up to each
+// event's time fire first, then the event is applied the way the watch
+// applies it. on_event (optional) sees each event just before it runs.
+// False when the replay is unusable or a game is still in progress.
+bool sim_play_replay(const Replay *replay, void (*on_event)(const ReplayEvent *event, void *context),
+                     void *context);
+// Ends a game left in progress (e.g. by a truncated replay) with a wrong press.
+void sim_finish_game(void);
+const SimStats *sim_get_stats(void);
@@ -0,0 +1,99 @@
+#include "benchmark.h"
+
+#if BENCH_ENABLED
+
+#include "game_core.h"
+#include "histogram.h"
+#include "power.h"
+#include "render.h"
+
+#include <string.h>
+
+// milliseconds; emulator frames land anywhere from 1 ms to a few hundred
+static const uint16_t s_ms_bounds[] = { 1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256 };
+
+static uint32_t (*s_now_ms)(void);
+static Histogram s_frame_hist;     // render update proc
+static Histogram s_late_hist;      // replay timer lateness
+static Histogram s_feedback_hist;  // replayed press -> end of the frame that shows it
+static uint32_t s_press_ms;
+static uint32_t s_heap_peak;
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+void bench_init(uint32_t (*now_ms)(void)) {
+  s_now_ms = now_ms;
+  histogram_init(&s_frame_hist, s_ms_bounds, ARRAY_LENGTH(s_ms_bounds));
+  histogram_init(&s_late_hist, s_ms_bounds, ARRAY_LENGTH(s_ms_bounds));
+  histogram_init(&s_feedback_hist, s_ms_bounds, ARRAY_LENGTH(s_ms_bounds));
+  s_heap_peak = heap_bytes_used();
+}
+
+bool bench_load_replay(Replay *out) {
+  static const char hex[] = PEBBLE_SAYS_BENCH_REPLAY;
+  uint8_t *bytes = (uint8_t *)out;
+  size_t size = 0;
+  memset(out, 0, sizeof(*out));
+  for (const char *p = hex; hex_value(p[0]) >= 0 && hex_value(p[1]) >= 0 && size < sizeof(*out); p += 2) {
+    bytes[size++] = (uint8_t)(hex_value(p[0]) << 4 | hex_value(p[1]));
+  }
+  return size >= sizeof(Replay) - REPLAY_ARENA_BYTES && size == replay_size(out) && replay_valid(out);
+}
+
+void bench_record(ProfileSlot slot, uint32_t elapsed_ms) {
+  if (slot != PROFILE_DRAW) return;
+  histogram_add(&s_frame_hist, elapsed_ms);
+  // every frame is a cheap, regular sample point for the heap
+  uint32_t used = heap_bytes_used();
+  if (used > s_heap_peak) s_heap_peak = used;
+}
+
+static void feedback_drawn(void) {
+  histogram_add(&s_feedback_hist, s_now_ms() - s_press_ms);
+}
+
+void bench_replay_event(uint32_t late_ms, bool feedback) {
+  histogram_add(&s_late_hist, late_ms);
+  if (!feedback) return;
+  s_press_ms = s_now_ms();
+  render_set_next_frame_handler(feedback_drawn);
+}
+
+static void log_histogram(const char *name, const Histogram *h) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH %s n %lu mean %lu p50 %lu p95 %lu max %lu", name, (unsigned long)h->total,
+          (unsigned long)histogram_mean(h), (unsigned long)histogram_percentile(h, 50),
+          (unsigned long)histogram_percentile(h, 95), (unsigned long)h->max);
+}
+
+static void log_timing(const char *name, ProfileSlot slot) {
+  const ProfileTiming *timing = profiler_get(slot);
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH %s n %lu max %u", name, (unsigned long)timing->count, timing->max_ms);
+}
+
+void bench_report(const Replay *replay, int seq_len) {
+  const GameTiming *edges = game_get_timing();
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH replay seed %lu events %u length %u", (unsigned long)replay->seed,
+          replay->events, replay->end_len);
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH result length %d %s", seq_len,
+          seq_len == replay->end_len ? "match" : "DIVERGED");
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH power %s", power_profile_name(power_get_profile()));
+  log_histogram("frame_ms", &s_frame_hist);
+  log_histogram("timer_late_ms", &s_late_hist);
+  log_histogram("feedback_ms", &s_feedback_hist);
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH edge_late_ms n %lu late %lu mean %lu max %ld", (unsigned long)edges->edges,
+          (unsigned long)edges->late_edges,
+          (unsigned long)(edges->edges ? edges->total_abs_error_ms / edges->edges : 0), (long)edges->max_error_ms);
+  log_timing("wakeup_ms", PROFILE_TIMER);
+  log_timing("input_ms", PROFILE_INPUT);
+  log_timing("edge_ms", PROFILE_EDGE);
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH heap peak %lu free %lu", (unsigned long)s_heap_peak,
+          (unsigned long)heap_bytes_free());
+  APP_LOG(APP_LOG_LEVEL_INFO, "BENCH done");
+}
+
+#endif
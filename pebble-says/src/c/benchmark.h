@@ -0,0 +1,37 @@
+#pragma once
+
+// Emulator benchmark build. `PEBBLE_SAYS_BENCH_REPLAY=<hex> pebble build`
+// (tools/emu_bench.py does this) embeds a replay, which the app plays back
+// once the first frame is up. Meanwhile it collects frame render times,
+// replay timer lateness, input-to-feedback latency and the heap peak, and
+// then logs them as "BENCH ..." lines. Other builds compile it out.
+
+#include <pebble.h>
+
+#include "profiler.h"
+#include "replay.h"
+
+#ifdef PEBBLE_SAYS_BENCH_REPLAY
+#define BENCH_ENABLED 1
+#else
+#define BENCH_ENABLED 0
+#endif
+
+#define BENCH_START_DELAY_MS 1000  // after the first frame
+
+#if BENCH_ENABLED
+#if !PROFILER_ENABLED
+#error "benchmark builds read the profiler hooks: don't combine them with --release"
+#endif
+
+void bench_init(uint32_t (*now_ms)(void));
+// Decodes the embedded replay; false if it isn't a valid one.
+bool bench_load_replay(Replay *out);
+// Called by profiler_record for every sample.
+void bench_record(ProfileSlot slot, uint32_t elapsed_ms);
+// A replayed event fired late_ms after its recorded time. A press the game
+// acts on (feedback) is timed until the end of the next frame drawn.
+void bench_replay_event(uint32_t late_ms, bool feedback);
+// Logs the report for a run that ended at length seq_len.
+void bench_report(const Replay *replay, int seq_len);
+#endif
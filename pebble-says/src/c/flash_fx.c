@@ -0,0 +1,79 @@
+#include "flash_fx.h"
+
+// Applies (b | set) ^ flip to n bytes, using aligned 32-bit words for the
+// bulk of the span.
+static void apply_bytes(uint8_t *p, int n, uint8_t set, uint8_t flip) {
+  while (n > 0 && ((uintptr_t)p & 3)) {
+    *p = (*p | set) ^ flip;
+    p++;
+    n--;
+  }
+  uint32_t set32 = set * 0x01010101U;
+  uint32_t flip32 = flip * 0x01010101U;
+  uint32_t *w = (uint32_t *)p;
+  for (; n >= 4; n -= 4, w++) {
+    *w = (*w | set32) ^ flip32;
+  }
+  p = (uint8_t *)w;
+  while (n-- > 0) {
+    *p = (*p | set) ^ flip;
+    p++;
+  }
+}
+
+#ifdef PBL_BW
+// 1-bit rows pack 8 pixels per byte, leftmost pixel in the low bit.
+static void invert_bits(uint8_t *row, int x0, int x1) {
+  int b0 = x0 >> 3;
+  int b1 = x1 >> 3;
+  uint8_t head = (uint8_t)(0xff << (x0 & 7));
+  uint8_t tail = (uint8_t)(0xff >> (7 - (x1 & 7)));
+  if (b0 == b1) {
+    row[b0] ^= head & tail;
+    return;
+  }
+  row[b0] ^= head;
+  row[b1] ^= tail;
+  apply_bytes(row + b0 + 1, b1 - b0 - 1, 0x00, 0xff);
+}
+#else
+// ARGB2222 (set, flip) per mode: invert flips the colour channels and keeps
+// the opaque alpha bits, tint forces red and green up for a yellow wash.
+static const uint8_t s_fx_bits[][2] = {
+  [FLASH_FX_NONE] = { 0x00, 0x00 },
+  [FLASH_FX_INVERT] = { 0x00, 0x3f },
+  [FLASH_FX_TINT] = { 0x3c, 0x00 },
+};
+#endif
+
+void flash_fx_apply(GContext *ctx, GRect region, FlashFxMode mode) {
+  if (mode == FLASH_FX_NONE || region.size.w <= 0 || region.size.h <= 0) return;
+  GBitmap *fb = graphics_capture_frame_buffer(ctx);
+  if (!fb) return;
+
+  GRect fb_bounds = gbitmap_get_bounds(fb);
+#ifndef PBL_BW
+  uint8_t set = s_fx_bits[mode][0];
+  uint8_t flip = s_fx_bits[mode][1];
+#endif
+  int y0 = region.origin.y < 0 ? 0 : region.origin.y;
+  int y1 = region.origin.y + region.size.h;
+  if (y1 > fb_bounds.size.h) y1 = fb_bounds.size.h;
+
+  for (int y = y0; y < y1; ++y) {
+    // row info also covers round displays, where each row has its own span
+    GBitmapDataRowInfo info = gbitmap_get_data_row_info(fb, y);
+    int x0 = region.origin.x > info.min_x ? region.origin.x : info.min_x;
+    int x1 = region.origin.x + region.size.w - 1;
+    if (x1 > info.max_x) x1 = info.max_x;
+    if (x1 < x0) continue;
+
+#ifdef PBL_BW
+    // tint has no colour to work with: it inverts too
+    invert_bits(info.data, x0, x1);
+#else
+    apply_bytes(info.data + x0, x1 - x0 + 1, set, flip);
+#endif
+  }
+  graphics_release_frame_buffer(ctx, fb);
+}
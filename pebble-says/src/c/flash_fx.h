@@ -0,0 +1,17 @@
+#pragma once
+
+// In-place framebuffer effects for the celebration flash. Instead of
+// painting an overlay layer, the captured framebuffer is inverted or tinted
+// directly, a word at a time, over any screen-space region.
+
+#include <pebble.h>
+
+typedef enum {
+  FLASH_FX_NONE = 0,
+  FLASH_FX_INVERT,  // its own inverse: applying it twice restores the frame
+  FLASH_FX_TINT,    // warm highlight on colour; same as invert on 1-bit
+} FlashFxMode;
+
+// Applies mode to region of the frame being rendered. Must be called from
+// an update proc, after everything underneath has been drawn.
+void flash_fx_apply(GContext *ctx, GRect region, FlashFxMode mode);
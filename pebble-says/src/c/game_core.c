@@ -0,0 +1,607 @@
+#include "game_core.h"
+#include "game_log.h"
+#include "replay.h"
+#include "seq_rng.h"
+#include "trace.h"
+
+#include <stdio.h>
+
+static const GamePlatform *s_platform;
+static GameState s_game;
+static SeqRng s_rng;
+static uint32_t s_next_seed = 1;
+static int s_glyph_pending = -1; // glyph lit by the last press, cleared by GAME_TIMER_GLYPH
+static uint32_t s_edge_deadline_ms; // absolute deadline of the next playback edge
+static uint32_t s_shown_deadline_ms; // deadline of the edge that ran last
+static bool s_edge_unshown;          // that edge waits for game_edge_shown()
+static GameTiming s_timing;
+
+// Type-ahead: presses that arrive while the sequence is showing or the round
+// is transitioning wait here and are replayed, in one batch, when the
+// "Your turn" prompt appears, if they fell within the acceptance window.
+typedef struct {
+  uint32_t at_ms;
+  uint8_t button;
+} QueuedPress;
+
+static QueuedPress s_typeahead[GAME_TYPEAHEAD_SLOTS];
+static uint8_t s_typeahead_head;
+static uint8_t s_typeahead_count;
+static uint32_t s_typeahead_window_ms = GAME_TYPEAHEAD_WINDOW_MS;
+static bool s_draining; // replaying a batch: one glyph-clear timer for the lot
+static GameInputStats s_input_stats;
+
+// bucket bounds in ms, finer where presses and short rounds cluster
+static const uint16_t s_reaction_bounds[] = {
+  100, 150, 200, 250, 300, 350, 400, 500, 600, 750, 1000, 1300, 1700, 2500, 4000
+};
+static const uint16_t s_round_bounds[] = {
+  500, 1000, 1500, 2000, 2500, 3000, 4000, 5000, 6000, 8000, 10000, 13000, 17000, 25000, 40000
+};
+static Histogram s_reaction_hist;
+static Histogram s_round_hist;
+static uint32_t s_prompt_ms;      // when "Your turn" appeared this round
+static uint32_t s_last_press_ms;  // reaction times are measured from here
+static bool s_unfocused;
+static uint32_t s_focus_lost_ms;
+static bool s_replaying;  // a replayed run: its presses were timed when it was played
+
+// Events the transition table dispatches on. The timer events share their
+// GameTimer's value, so game_timer_fired() indexes the table directly.
+typedef enum {
+  GAME_EV_SEQUENCE = GAME_TIMER_SEQUENCE,
+  GAME_EV_GLYPH = GAME_TIMER_GLYPH,
+  GAME_EV_FEEDBACK = GAME_TIMER_FEEDBACK,
+  GAME_EV_TRANSITION = GAME_TIMER_TRANSITION,
+  GAME_EV_PRESS = GAME_TIMER_COUNT,  // arg = SequenceButton
+  GAME_EV_SELECT,                    // Select: starts a game from GAME_PHASE_OVER
+  GAME_EV_FOCUS_LOST,
+  GAME_EV_FOCUS_REGAINED,            // arg = ms spent without focus
+  GAME_EV_COUNT
+} GameEvent;
+
+typedef void (*GameHandler)(int arg);
+
+static void drain_typeahead(void);
+static void start_show_sequence(void);
+
+const char *game_button_name(int b) {
+  switch (b) {
+    case SEQ_BTN_UP: return "Up";
+    case SEQ_BTN_SELECT: return "Select";
+    case SEQ_BTN_DOWN: return "Down";
+    default: return "?";
+  }
+}
+
+const GameState *game_get_state(void) {
+  return &s_game;
+}
+
+const GameTiming *game_get_timing(void) {
+  return &s_timing;
+}
+
+void game_reset_timing(void) {
+  s_timing = (GameTiming) { 0 };
+  s_edge_unshown = false;
+}
+
+const Histogram *game_get_reaction_histogram(void) {
+  return &s_reaction_hist;
+}
+
+const Histogram *game_get_round_histogram(void) {
+  return &s_round_hist;
+}
+
+void game_reset_histograms(void) {
+  histogram_init(&s_reaction_hist, s_reaction_bounds, sizeof(s_reaction_bounds) / sizeof(s_reaction_bounds[0]));
+  histogram_init(&s_round_hist, s_round_bounds, sizeof(s_round_bounds) / sizeof(s_round_bounds[0]));
+}
+
+static void record_reaction(uint32_t at_ms) {
+  int32_t reaction = (int32_t)(at_ms - s_last_press_ms);
+  // type-ahead presses beat the prompt; count them as instant
+  if (!s_replaying) histogram_add(&s_reaction_hist, reaction > 0 ? (uint32_t)reaction : 0);
+  if (reaction > 0) s_last_press_ms = at_ms;
+}
+
+const GameInputStats *game_get_input_stats(void) {
+  return &s_input_stats;
+}
+
+void game_set_typeahead_window(uint32_t ms) {
+  s_typeahead_window_ms = ms;
+}
+
+static void clear_typeahead(void) {
+  s_input_stats.dropped += s_typeahead_count;
+  s_typeahead_head = 0;
+  s_typeahead_count = 0;
+}
+
+static void queue_press(SequenceButton pressed) {
+  if (s_typeahead_window_ms == 0) {
+    s_input_stats.dropped++;
+    return;
+  }
+  if (s_typeahead_count == GAME_TYPEAHEAD_SLOTS) {
+    // full: the oldest press is the least likely to be in the window
+    s_typeahead_head = (s_typeahead_head + 1) % GAME_TYPEAHEAD_SLOTS;
+    s_typeahead_count--;
+    s_input_stats.dropped++;
+  }
+  QueuedPress *slot = &s_typeahead[(s_typeahead_head + s_typeahead_count) % GAME_TYPEAHEAD_SLOTS];
+  slot->at_ms = s_platform->now_ms();
+  slot->button = (uint8_t)pressed;
+  s_typeahead_count++;
+  s_input_stats.queued++;
+  GAME_TRACE(TRACE_EV_QUEUED, pressed, s_typeahead_count);
+}
+
+// step n depends only on (seed, n), so nothing per step is kept in RAM
+static inline int step_at(int index) {
+  return seq_rng_at(&s_rng, (uint32_t)index);
+}
+
+int game_sequence_step(int index) {
+  if (index < 0 || index >= s_game.seq_len) return -1;
+  return step_at(index);
+}
+
+int game_max_sequence(GameMode mode) {
+  return mode == GAME_MODE_ENDLESS ? ENDLESS_MAX_SEQUENCE : MAX_SEQUENCE;
+}
+
+static void add_random_step(void) {
+  if (s_game.seq_len < game_max_sequence(s_game.mode)) {
+    s_game.seq_len++;
+    GAME_TRACE(TRACE_EV_STEP, step_at(s_game.seq_len - 1), s_game.seq_len);
+    GAME_LOG_DEBUG("Added step %d (len=%d)", step_at(s_game.seq_len-1), s_game.seq_len);
+  }
+}
+
+int calc_show_ms(int len) {
+  // Steeper early, gentler later; floor at 200ms
+  int ms;
+  if (len <= 1) ms = SHOW_MS;
+  else if (len <= 3) ms = SHOW_MS - 60 * (len - 1);
+  else ms = SHOW_MS - 60 * 2 - 35 * (len - 3);
+  if (ms < 200) ms = 200;
+  return ms;
+}
+
+static void begin_round(void) {
+  s_game.input_index = 0;
+  s_game.round = s_game.seq_len;
+  // speed ramp with piecewise curve
+  s_game.show_ms = calc_show_ms(s_game.seq_len);
+  s_platform->update_info();
+  GAME_TRACE(TRACE_EV_ROUND, s_game.show_ms / 4, s_game.round);
+  GAME_LOG_INFO("Begin round %d (seq_len=%d, show_ms=%d)", s_game.round, s_game.seq_len, s_game.show_ms);
+  // start showing immediately
+  start_show_sequence();
+  s_platform->apply_layout();
+}
+
+static void end_game(void) {
+  s_game.phase = GAME_PHASE_OVER;
+  s_platform->cancel_timer(GAME_TIMER_FEEDBACK);
+  GAME_TRACE(TRACE_EV_GAME_OVER, 0, s_game.round);
+  replay_record_end(false, (uint16_t)s_game.seq_len);
+  GAME_LOG_INFO("Game over at round %d, seq_len=%d", s_game.round, s_game.seq_len);
+  s_platform->update_info();
+  s_platform->show_message("Game Over");
+  s_platform->apply_layout();
+  if (s_platform->game_finished) s_platform->game_finished(false);
+}
+
+// Arms the next edge `duration` after the previous edge's deadline, not
+// after now, so callback latency doesn't push the rest of the round back.
+static void schedule_edge(uint32_t duration) {
+  s_edge_deadline_ms += duration;
+  int32_t delay = (int32_t)(s_edge_deadline_ms - s_platform->now_ms());
+  s_platform->schedule_timer(GAME_TIMER_SEQUENCE, delay > 0 ? (uint32_t)delay : 0);
+}
+
+static void measure_edge(uint32_t shown_ms, uint32_t deadline_ms) {
+  int32_t error = (int32_t)(shown_ms - deadline_ms);
+  s_timing.edges++;
+  s_timing.last_error_ms = error;
+  if (error > 0) s_timing.late_edges++;
+  if (error > s_timing.max_error_ms) s_timing.max_error_ms = error;
+  s_timing.total_abs_error_ms += (uint32_t)(error < 0 ? -error : error);
+  if (error > 0) GAME_TRACE(TRACE_EV_LATE_EDGE, GAME_TIMER_SEQUENCE, error);
+}
+
+// Called as an edge runs, before it schedules the next one.
+static void record_edge_error(void) {
+  if (!s_platform->reports_edge_shown) {
+    measure_edge(s_platform->now_ms(), s_edge_deadline_ms);
+    return;
+  }
+  s_shown_deadline_ms = s_edge_deadline_ms;
+  s_edge_unshown = true;
+}
+
+void game_edge_shown(uint32_t shown_ms) {
+  if (!s_edge_unshown) return;
+  s_edge_unshown = false;
+  measure_edge(shown_ms, s_shown_deadline_ms);
+}
+
+static void prompt_player(void) {
+  s_game.phase = GAME_PHASE_INPUT;
+  // clear any highlighted glyphs
+  for (int i = 0; i < 3; ++i) s_platform->highlight_glyph(i, false);
+  s_platform->show_message("Your turn");
+  s_prompt_ms = s_last_press_ms = s_platform->now_ms();
+  drain_typeahead();
+}
+
+// End of a gap: light the next step, or hand over once all were shown.
+static void leave_gap(void) {
+  if (s_game.show_index >= s_game.seq_len) {
+    prompt_player();
+    return;
+  }
+  int step = step_at(s_game.show_index);
+  s_platform->show_message(game_button_name(step));
+  s_platform->highlight_glyph(step, true);
+  s_game.phase = GAME_PHASE_SHOW;
+  schedule_edge(s_game.show_ms);
+}
+
+static void on_gap_edge(int arg) {
+  record_edge_error();
+  leave_gap();
+}
+
+static void on_show_edge(int arg) {
+  record_edge_error();
+  // pause between steps: clear the highlight for the step just shown
+  s_platform->show_message("");
+  s_platform->highlight_glyph(step_at(s_game.show_index), false);
+  s_game.phase = GAME_PHASE_GAP;
+  s_game.show_index++;
+  schedule_edge(PAUSE_MS);
+}
+
+static void start_show_sequence(void) {
+  // input is queued from here until the prompt
+  s_game.phase = GAME_PHASE_GAP;
+  s_game.show_index = 0;
+  s_game.round_start_ms = s_platform->now_ms();
+  s_edge_deadline_ms = s_game.round_start_ms;
+  // a press just before the restart mustn't clear the first step when its
+  // highlight times out
+  if (s_glyph_pending >= 0) {
+    s_platform->cancel_timer(GAME_TIMER_GLYPH);
+    s_platform->highlight_glyph(s_glyph_pending, false);
+    s_glyph_pending = -1;
+  }
+  GAME_LOG_DEBUG("Starting to show sequence (len=%d, show_ms=%d)", s_game.seq_len, s_game.show_ms);
+  leave_gap();
+}
+
+static void on_feedback_timer(int arg) {
+  // after brief "Good" feedback, prompt the player for the next input
+  s_platform->show_message("Your turn");
+}
+
+static void on_glyph_timer(int arg) {
+  s_platform->highlight_glyph(s_glyph_pending, false);
+  s_glyph_pending = -1;
+}
+
+static void start_round_transition(void) {
+  s_game.phase = GAME_PHASE_TRANSITION;
+  // a pending "Good" -> "Your turn" restore must not overwrite the celebration
+  s_platform->cancel_timer(GAME_TIMER_FEEDBACK);
+  // one pattern per round end; milestones get a longer tail
+  if (s_game.seq_len == 4 || s_game.seq_len == 6) {
+    s_platform->vibe(GAME_VIBE_MILESTONE);
+  } else if (s_game.seq_len == 8) {
+    s_platform->vibe(GAME_VIBE_FINAL);
+  } else {
+    s_platform->vibe(GAME_VIBE_ROUND);
+  }
+  static char buf[32];
+  snprintf(buf, sizeof(buf), "Length %d", s_game.seq_len); // center celebration text
+  s_platform->show_message(buf);
+  // start flash animation (more cycles for milestones)
+  int cycles = (s_game.seq_len == 4 || s_game.seq_len == 6) ? 5 : (s_game.seq_len == 8 ? 7 : 3);
+  s_platform->start_celebration(cycles);
+  // slightly longer than flash cycles to allow finish before next round
+  int duration = 150 * cycles + 200;
+  s_platform->schedule_timer(GAME_TIMER_TRANSITION, duration);
+}
+
+static void on_transition_timer(int arg) {
+  // ensure flash ends
+  s_platform->stop_celebration();
+  begin_round();
+}
+
+// Only reached in GAME_PHASE_INPUT, so input_index < seq_len.
+static void accept_press(SequenceButton pressed, uint32_t at_ms) {
+  GAME_TRACE(TRACE_EV_PRESS, pressed, s_game.input_index);
+  record_reaction(at_ms);
+  GAME_LOG_DEBUG("Button pressed: %d, expecting: %d (idx=%d)", pressed, step_at(s_game.input_index), s_game.input_index);
+
+  // visual/vibe feedback for press
+  if (s_glyph_pending >= 0 && s_glyph_pending != (int)pressed) {
+    s_platform->highlight_glyph(s_glyph_pending, false);
+  }
+  s_platform->highlight_glyph(pressed, true);
+  s_glyph_pending = pressed;
+  if (!s_draining) s_platform->schedule_timer(GAME_TIMER_GLYPH, 150);
+
+  if ((int)pressed == step_at(s_game.input_index)) {
+    // correct; a round-ending press gets the round's pattern instead of a tick
+    s_game.input_index++;
+    GAME_LOG_DEBUG("Correct press, new input_index=%d", s_game.input_index);
+    if (s_game.input_index == s_game.seq_len) {
+      // completed round
+      int32_t round_ms = (int32_t)(at_ms - s_prompt_ms);
+      if (!s_replaying) histogram_add(&s_round_hist, round_ms > 0 ? (uint32_t)round_ms : 0);
+      if (s_game.seq_len >= game_max_sequence(s_game.mode)) {
+        // won at max length
+        s_game.phase = GAME_PHASE_OVER;
+        s_platform->cancel_timer(GAME_TIMER_FEEDBACK);
+        s_platform->update_info();
+        s_platform->show_message("You win!");
+        s_platform->vibe(GAME_VIBE_WIN);
+        GAME_TRACE(TRACE_EV_WIN, 0, s_game.seq_len);
+        replay_record_end(true, (uint16_t)s_game.seq_len);
+        GAME_LOG_INFO("Player won at max sequence length %d", s_game.seq_len);
+        if (s_platform->game_finished) s_platform->game_finished(true);
+      } else {
+        // prepare next round
+        add_random_step();
+        s_game.round = s_game.seq_len;
+        s_platform->update_info();
+        GAME_LOG_DEBUG("Round complete, starting transition (len=%d)", s_game.seq_len);
+        // visual confirmation for end of round
+        start_round_transition();
+      }
+    } else {
+      // prompt for next input
+      s_platform->vibe(GAME_VIBE_CORRECT);
+      s_platform->show_message("Good");
+      // brief feedback, then restore the prompt without restarting the sequence
+      s_platform->schedule_timer(GAME_TIMER_FEEDBACK, 200);
+    }
+  } else {
+    // wrong
+    s_platform->vibe(GAME_VIBE_WRONG);
+    GAME_TRACE(TRACE_EV_WRONG, pressed, s_game.input_index);
+    GAME_LOG_INFO("Wrong press: %d (expected %d) at idx=%d", pressed, step_at(s_game.input_index), s_game.input_index);
+    end_game();
+  }
+}
+
+static void drain_typeahead(void) {
+  if (!s_typeahead_count) return;
+  uint32_t prompt_ms = s_platform->now_ms();
+  s_draining = true;
+  while (s_typeahead_count && s_game.phase == GAME_PHASE_INPUT) {
+    QueuedPress press = s_typeahead[s_typeahead_head];
+    s_typeahead_head = (s_typeahead_head + 1) % GAME_TYPEAHEAD_SLOTS;
+    s_typeahead_count--;
+    if (prompt_ms - press.at_ms > s_typeahead_window_ms) {
+      // pressed well before the prompt: the player wasn't answering yet
+      s_input_stats.dropped++;
+      continue;
+    }
+    s_input_stats.replayed++;
+    accept_press((SequenceButton)press.button, press.at_ms);
+  }
+  s_draining = false;
+  // anything left arrived in a round that has already ended
+  clear_typeahead();
+  if (s_glyph_pending >= 0) s_platform->schedule_timer(GAME_TIMER_GLYPH, 150);
+}
+
+static void on_press_accepted(int button) {
+  accept_press((SequenceButton)button, s_platform->now_ms());
+}
+
+static void on_press_queued(int button) {
+  // hold presses at the edge of "Your turn" instead of dropping them
+  GAME_LOG_DEBUG("Input queued in phase %d: %d", s_game.phase, button);
+  queue_press((SequenceButton)button);
+}
+
+static void on_press_ignored(int button) {
+  // only Select restarts
+  GAME_LOG_DEBUG("Input ignored - game over: %d", button);
+}
+
+static void on_new_game(int arg) {
+  // restart game - start at length 1 instead of 2
+  s_game.seed = s_next_seed;
+  s_next_seed = seq_rng_next_seed(s_next_seed);
+  seq_rng_seed(&s_rng, s_game.seed);
+  GAME_TRACE(TRACE_EV_NEW_GAME, s_game.mode, s_game.seed & 0xffff);
+  GAME_LOG_INFO("New game, seed=%lu", (unsigned long)s_game.seed);
+  s_game.seq_len = 0;
+  s_game.round = 0;
+  s_replaying = false;
+  clear_typeahead();
+  add_random_step();
+  replay_record_start((uint8_t)s_game.mode, s_game.seed, (uint16_t)s_game.seq_len, s_platform->now_ms());
+  begin_round();
+  s_platform->apply_layout();
+}
+
+static void on_focus_lost_showing(int arg) {
+  s_platform->cancel_timer(GAME_TIMER_SEQUENCE);
+}
+
+static void on_focus_regained_input(int away_ms) {
+  // the time spent covered isn't reaction time
+  s_prompt_ms += (uint32_t)away_ms;
+  s_last_press_ms += (uint32_t)away_ms;
+}
+
+static void on_focus_regained_gap(int away_ms) {
+  // the step on screen may have been covered: show it again after a gap
+  s_platform->show_message("");
+  s_game.round_start_ms += (uint32_t)away_ms;
+  s_edge_deadline_ms = s_platform->now_ms();
+  schedule_edge(PAUSE_MS);
+}
+
+static void on_focus_regained_show(int away_ms) {
+  s_platform->highlight_glyph(step_at(s_game.show_index), false);
+  s_game.phase = GAME_PHASE_GAP;
+  on_focus_regained_gap(away_ms);
+}
+
+// (phase, event) -> handler; an empty entry ignores the event. A timer
+// event only has an entry in the phases that arm that timer.
+static const GameHandler s_transitions[GAME_PHASE_COUNT][GAME_EV_COUNT] = {
+  [GAME_PHASE_OVER] = {
+    [GAME_EV_GLYPH] = on_glyph_timer,
+    [GAME_EV_PRESS] = on_press_ignored,
+    [GAME_EV_SELECT] = on_new_game,
+  },
+  [GAME_PHASE_GAP] = {
+    [GAME_EV_SEQUENCE] = on_gap_edge,
+    [GAME_EV_GLYPH] = on_glyph_timer,
+    [GAME_EV_PRESS] = on_press_queued,
+    [GAME_EV_SELECT] = on_press_queued,
+    [GAME_EV_FOCUS_LOST] = on_focus_lost_showing,
+    [GAME_EV_FOCUS_REGAINED] = on_focus_regained_gap,
+  },
+  [GAME_PHASE_SHOW] = {
+    [GAME_EV_SEQUENCE] = on_show_edge,
+    [GAME_EV_GLYPH] = on_glyph_timer,
+    [GAME_EV_PRESS] = on_press_queued,
+    [GAME_EV_SELECT] = on_press_queued,
+    [GAME_EV_FOCUS_LOST] = on_focus_lost_showing,
+    [GAME_EV_FOCUS_REGAINED] = on_focus_regained_show,
+  },
+  [GAME_PHASE_INPUT] = {
+    [GAME_EV_GLYPH] = on_glyph_timer,
+    [GAME_EV_FEEDBACK] = on_feedback_timer,
+    [GAME_EV_PRESS] = on_press_accepted,
+    [GAME_EV_SELECT] = on_press_accepted,
+    [GAME_EV_FOCUS_REGAINED] = on_focus_regained_input,
+  },
+  [GAME_PHASE_TRANSITION] = {
+    [GAME_EV_GLYPH] = on_glyph_timer,
+    [GAME_EV_TRANSITION] = on_transition_timer,
+    [GAME_EV_PRESS] = on_press_queued,
+    [GAME_EV_SELECT] = on_press_queued,
+  },
+};
+
+static inline void dispatch(GameEvent event, int arg) {
+  GameHandler handler = s_transitions[s_game.phase][event];
+  if (handler) handler(arg);
+}
+
+void game_press(SequenceButton pressed) {
+  replay_record_event((ReplayCode)pressed, 0, s_platform->now_ms());
+  dispatch(GAME_EV_PRESS, pressed);
+}
+
+void game_select(void) {
+  // nothing is recording between games, so a starting Select isn't logged
+  replay_record_event(REPLAY_CODE_SELECT, 0, s_platform->now_ms());
+  dispatch(GAME_EV_SELECT, SEQ_BTN_SELECT);
+}
+
+void game_timer_fired(GameTimer timer) {
+  if (timer < 0 || timer >= GAME_TIMER_COUNT) return;
+  dispatch((GameEvent)timer, 0);
+}
+
+void game_focus_lost(void) {
+  if (s_unfocused) return;
+  s_unfocused = true;
+  s_focus_lost_ms = s_platform->now_ms();
+  GAME_TRACE(TRACE_EV_FOCUS, 0, game_is_showing(&s_game) ? s_game.show_index : -1);
+  replay_record_event(REPLAY_CODE_EXT, REPLAY_EXT_FOCUS_LOST, s_focus_lost_ms);
+  dispatch(GAME_EV_FOCUS_LOST, 0);
+}
+
+void game_focus_regained(void) {
+  if (!s_unfocused) return;
+  s_unfocused = false;
+  GAME_TRACE(TRACE_EV_FOCUS, 1, game_is_showing(&s_game) ? s_game.show_index : -1);
+  replay_record_event(REPLAY_CODE_EXT, REPLAY_EXT_FOCUS_REGAINED, s_platform->now_ms());
+  dispatch(GAME_EV_FOCUS_REGAINED, (int)(s_platform->now_ms() - s_focus_lost_ms));
+}
+
+bool game_snapshot(GameSnapshot *out) {
+  if (game_is_over(&s_game) || s_game.seq_len <= 0) return false;
+  *out = (GameSnapshot) {
+    .version = GAME_SNAPSHOT_VERSION,
+    .mode = (uint8_t)s_game.mode,
+    .seq_len = (uint16_t)s_game.seq_len,
+    .seed = s_game.seed,
+    .next_seed = s_next_seed,
+  };
+  return true;
+}
+
+bool game_resume(const GameSnapshot *snapshot) {
+  if (!game_is_over(&s_game)) return false;
+  if (snapshot->version != GAME_SNAPSHOT_VERSION || snapshot->mode >= GAME_MODE_COUNT) return false;
+  if (snapshot->seq_len < 1 || snapshot->seq_len > game_max_sequence((GameMode)snapshot->mode)) return false;
+  s_game.mode = (GameMode)snapshot->mode;
+  s_game.seed = snapshot->seed;
+  s_next_seed = snapshot->next_seed;
+  seq_rng_seed(&s_rng, s_game.seed);
+  s_game.seq_len = snapshot->seq_len;
+  s_replaying = false;
+  GAME_TRACE(TRACE_EV_NEW_GAME, s_game.mode, s_game.seed & 0xffff);
+  GAME_LOG_INFO("Resumed game, seed=%lu, seq_len=%d", (unsigned long)s_game.seed, s_game.seq_len);
+  clear_typeahead();
+  replay_record_start((uint8_t)s_game.mode, s_game.seed, (uint16_t)s_game.seq_len, s_platform->now_ms());
+  begin_round();
+  return true;
+}
+
+bool game_start_replay(const Replay *replay) {
+  if (!replay_valid(replay)) return false;
+  GameSnapshot snapshot = {
+    .version = GAME_SNAPSHOT_VERSION,
+    .mode = replay->mode,
+    .seq_len = replay->start_len,
+    .seed = replay->seed,
+    .next_seed = seq_rng_next_seed(replay->seed),
+  };
+  if (!game_resume(&snapshot)) return false;
+  s_replaying = true;
+  return true;
+}
+
+void game_seed(uint32_t seed) {
+  s_next_seed = seed;
+}
+
+void game_set_mode(GameMode mode) {
+  if (!game_is_over(&s_game) || mode < 0 || mode >= GAME_MODE_COUNT) return;
+  s_game.mode = mode;
+}
+
+void game_init(const GamePlatform *platform) {
+  s_platform = platform;
+  s_game = (GameState) {
+    .mode = GAME_MODE_CLASSIC,
+    .phase = GAME_PHASE_OVER, // show start message until user presses select
+    .show_ms = SHOW_MS,
+  };
+  s_glyph_pending = -1;
+  s_unfocused = false;
+  s_replaying = false;
+  s_typeahead_head = s_typeahead_count = 0;
+  s_input_stats = (GameInputStats) { 0 };
+  game_reset_timing();
+  game_reset_histograms();
+}
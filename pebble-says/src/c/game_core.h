@@ -0,0 +1,193 @@
+#pragma once
+
+// Platform-free Pebble Says game logic. The watch app and the host harness
+// both drive it through a GamePlatform; nothing in here touches pebble.h.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "histogram.h"
+#include "replay.h"
+
+#define MAX_SEQUENCE 8             // classic mode: win at this length
+#define ENDLESS_MAX_SEQUENCE 9999  // endless mode cap, keeps "Round: %d" short
+#define SHOW_MS 700  // base show duration; will ramp down each round
+#define PAUSE_MS 300
+
+#define GAME_TYPEAHEAD_SLOTS 8
+#ifndef GAME_TYPEAHEAD_WINDOW_MS
+#define GAME_TYPEAHEAD_WINDOW_MS 250  // presses this close before "Your turn" still count
+#endif
+
+typedef enum {
+  SEQ_BTN_UP = 0,
+  SEQ_BTN_SELECT = 1,
+  SEQ_BTN_DOWN = 2
+} SequenceButton;
+
+// Timers the core asks the platform to run. Scheduling a timer that is
+// already pending replaces it; the platform calls game_timer_fired() when
+// one expires.
+typedef enum {
+  GAME_TIMER_SEQUENCE = 0,  // show/pause edges of sequence playback
+  GAME_TIMER_GLYPH,         // clears the highlight of a pressed glyph
+  GAME_TIMER_FEEDBACK,      // restores "Your turn" after "Good"
+  GAME_TIMER_TRANSITION,    // end of the round-complete celebration
+  GAME_TIMER_COUNT
+} GameTimer;
+
+typedef enum {
+  GAME_MODE_CLASSIC = 0,
+  GAME_MODE_ENDLESS,
+  GAME_MODE_COUNT
+} GameMode;
+
+// Haptic events, one per occasion; the platform picks the pattern.
+typedef enum {
+  GAME_VIBE_CORRECT = 0,  // correct press that doesn't end the round
+  GAME_VIBE_WRONG,        // wrong press, game over
+  GAME_VIBE_ROUND,        // round complete
+  GAME_VIBE_MILESTONE,    // round complete at length 4 or 6
+  GAME_VIBE_FINAL,        // round complete at length 8
+  GAME_VIBE_WIN,          // won at the mode's maximum length
+  GAME_VIBE_COUNT
+} GameVibe;
+
+// Where the game is. Every event is handled by the (phase, event) entry of
+// one transition table, so the phase alone decides what a press or timer
+// does.
+typedef enum {
+  GAME_PHASE_OVER = 0,    // title, lost or won: Select starts a game
+  GAME_PHASE_GAP,         // blank before step show_index, or before the prompt
+  GAME_PHASE_SHOW,        // step show_index is lit
+  GAME_PHASE_INPUT,       // the player repeats the sequence
+  GAME_PHASE_TRANSITION,  // round-end celebration; presses are queued
+  GAME_PHASE_COUNT
+} GamePhase;
+
+typedef struct {
+  uint32_t seed;       // seed of the current game's sequence
+  GameMode mode;
+  GamePhase phase;
+  int seq_len;
+  int input_index;
+  int round;
+  int show_index;
+  int show_ms;         // dynamically adjusted show time
+  uint32_t round_start_ms;  // when the current round's playback started
+} GameState;
+
+static inline bool game_is_over(const GameState *game) {
+  return game->phase == GAME_PHASE_OVER;
+}
+
+static inline bool game_is_showing(const GameState *game) {
+  return game->phase == GAME_PHASE_GAP || game->phase == GAME_PHASE_SHOW;
+}
+
+// Lateness of playback edges against their absolute deadlines. Every edge
+// is scheduled from the round start, so lateness is corrected at the next
+// edge instead of accumulating over the sequence. An edge is measured when
+// it reaches the screen if the platform reports that, else when it runs.
+typedef struct {
+  uint32_t edges;           // edges measured
+  uint32_t late_edges;      // edges shown after their deadline
+  int32_t last_error_ms;    // + late, - early
+  int32_t max_error_ms;     // largest lateness seen
+  uint32_t total_abs_error_ms;
+} GameTiming;
+
+typedef struct {
+  void (*show_message)(const char *msg);
+  void (*highlight_glyph)(int idx, bool on);
+  void (*update_info)(void);
+  void (*apply_layout)(void);
+  void (*vibe)(GameVibe vibe);
+  void (*start_celebration)(int cycles);
+  void (*stop_celebration)(void);
+  void (*schedule_timer)(GameTimer timer, uint32_t ms);
+  void (*cancel_timer)(GameTimer timer);
+  uint32_t (*now_ms)(void);  // monotonic milliseconds; may wrap
+  // The platform stages sequence edges and calls game_edge_shown() when
+  // each one is committed to the screen; the edge is measured then.
+  bool reports_edge_shown;
+  // Optional: a game just ended (won at max length, or a wrong press). Runs
+  // on the input path, so keep it to bookkeeping and defer any real work.
+  void (*game_finished)(bool won);
+} GamePlatform;
+
+// Resets to the title state (game over with an empty sequence).
+void game_init(const GamePlatform *platform);
+
+// Seeds the next game. Each game after that derives its seed from the
+// previous one, so a single seed reproduces a whole session.
+void game_seed(uint32_t seed);
+
+// Selects the mode for the next game; ignored while a game is running.
+void game_set_mode(GameMode mode);
+int game_max_sequence(GameMode mode);
+
+// Minimal state to resume a run in a later launch. Steps are regenerated
+// from the seed, so none are stored. The round restarts from its first step
+// because the player has to see the sequence again.
+#define GAME_SNAPSHOT_VERSION 1
+typedef struct {
+  uint8_t version;
+  uint8_t mode;
+  uint16_t seq_len;
+  uint32_t seed;       // this game's sequence
+  uint32_t next_seed;  // keeps the session's seed chain going
+} GameSnapshot;
+
+// False (and out untouched) when no game is in progress.
+bool game_snapshot(GameSnapshot *out);
+// Validates the snapshot and jumps straight into its round; false if unusable.
+bool game_resume(const GameSnapshot *snapshot);
+
+// The app lost or regained focus (a notification or other modal covers
+// it). Losing focus stops playback; regaining it replays the step that was
+// showing, after a short pause, and the interrupted time is left out of
+// the reaction and round clocks. The platform freezes its other timers.
+void game_focus_lost(void);
+void game_focus_regained(void);
+
+// Replays (see replay.h): the core records every run it plays. Starting a
+// replay jumps into its first round like a resumed snapshot; the caller
+// then feeds each event back, at its recorded time, through the same path
+// live input and focus changes take. Its presses stay out of the reaction
+// and round histograms until the next game starts.
+bool game_start_replay(const Replay *replay);
+
+// Select restarts a finished game, otherwise it counts as an input.
+void game_select(void);
+void game_press(SequenceButton pressed);
+void game_timer_fired(GameTimer timer);
+// The last sequence edge reached the screen at shown_ms (platform clock);
+// only used with reports_edge_shown.
+void game_edge_shown(uint32_t shown_ms);
+
+const GameState *game_get_state(void);
+typedef struct {
+  uint32_t queued;    // presses held while showing or transitioning
+  uint32_t replayed;  // queued presses applied when the prompt appeared
+  uint32_t dropped;   // queued presses outside the window, or overflow
+} GameInputStats;
+
+const GameTiming *game_get_timing(void);
+const GameInputStats *game_get_input_stats(void);
+
+// Reaction: time from the "Your turn" prompt, or the previous press of the
+// round, to each press (0 for presses made ahead of the prompt). Round:
+// prompt to the last correct press of a completed round. Milliseconds.
+const Histogram *game_get_reaction_histogram(void);
+const Histogram *game_get_round_histogram(void);
+void game_reset_histograms(void);
+
+// Type-ahead acceptance window before the prompt; 0 drops early presses.
+void game_set_typeahead_window(uint32_t ms);
+void game_reset_timing(void);
+// Steps are regenerated from the seed on demand rather than stored, so
+// sequence length costs no memory in either mode.
+int game_sequence_step(int index);
+const char *game_button_name(int b);
+int calc_show_ms(int len);
@@ -0,0 +1,41 @@
+#pragma once
+
+// Logging for code shared between the watch app and the host harness.
+// Calls above GAME_LOG_LEVEL compile out entirely, arguments included.
+// Release builds (wscript --release defines PEBBLE_SAYS_RELEASE) and host
+// builds default to NONE; debug watch builds log INFO. Per-press detail is
+// DEBUG, so it costs nothing unless a build asks for it with
+// -DGAME_LOG_LEVEL=GAME_LOG_LEVEL_DEBUG; the trace ring (trace.h) covers
+// the hot path without formatting.
+
+#define GAME_LOG_LEVEL_NONE 0
+#define GAME_LOG_LEVEL_INFO 1
+#define GAME_LOG_LEVEL_DEBUG 2
+
+#ifndef GAME_LOG_LEVEL
+#if defined(PEBBLE_SAYS_HOST) || defined(PEBBLE_SAYS_RELEASE)
+#define GAME_LOG_LEVEL GAME_LOG_LEVEL_NONE
+#else
+#define GAME_LOG_LEVEL GAME_LOG_LEVEL_INFO
+#endif
+#endif
+
+#ifdef PEBBLE_SAYS_HOST
+#include <stdio.h>
+#define GAME_LOG_EMIT(level, fmt, ...) fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+#else
+#include <pebble.h>
+#define GAME_LOG_EMIT(level, fmt, ...) APP_LOG(level, fmt, ##__VA_ARGS__)
+#endif
+
+#if GAME_LOG_LEVEL >= GAME_LOG_LEVEL_DEBUG
+#define GAME_LOG_DEBUG(fmt, ...) GAME_LOG_EMIT(APP_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define GAME_LOG_DEBUG(fmt, ...) ((void)0)
+#endif
+
+#if GAME_LOG_LEVEL >= GAME_LOG_LEVEL_INFO
+#define GAME_LOG_INFO(fmt, ...) GAME_LOG_EMIT(APP_LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define GAME_LOG_INFO(fmt, ...) ((void)0)
+#endif
@@ -0,0 +1,99 @@
+#include "haptics.h"
+
+#ifndef ARRAY_LENGTH
+#define ARRAY_LENGTH(a) (sizeof(a) / sizeof((a)[0]))
+#endif
+#define PATTERN(d) { .durations = (d), .num_segments = ARRAY_LENGTH(d) }
+
+// on, off, on, ... in ms
+static const uint32_t s_full_correct[] = { 40 };
+static const uint32_t s_full_wrong[] = { 400 };
+static const uint32_t s_full_round[] = { 80, 80, 80 };
+static const uint32_t s_full_milestone[] = { 80, 80, 80, 80, 160 };
+static const uint32_t s_full_final[] = { 80, 80, 80, 80, 400 };
+static const uint32_t s_full_win[] = { 80, 80, 80, 80, 80, 80, 500 };
+
+static const uint32_t s_reduced_wrong[] = { 200 };
+static const uint32_t s_reduced_round[] = { 60 };
+static const uint32_t s_reduced_milestone[] = { 60, 80, 60 };
+static const uint32_t s_reduced_final[] = { 60, 80, 200 };
+static const uint32_t s_reduced_win[] = { 60, 80, 60, 80, 250 };
+
+typedef struct {
+  VibePattern pattern;
+  uint8_t priority;  // a playing pattern only yields to a higher priority
+} Haptic;
+
+static const Haptic s_haptics[HAPTICS_MODE_COUNT][GAME_VIBE_COUNT] = {
+  [HAPTICS_MODE_FULL] = {
+    [GAME_VIBE_CORRECT] = { PATTERN(s_full_correct), 0 },
+    [GAME_VIBE_WRONG] = { PATTERN(s_full_wrong), 2 },
+    [GAME_VIBE_ROUND] = { PATTERN(s_full_round), 1 },
+    [GAME_VIBE_MILESTONE] = { PATTERN(s_full_milestone), 1 },
+    [GAME_VIBE_FINAL] = { PATTERN(s_full_final), 1 },
+    [GAME_VIBE_WIN] = { PATTERN(s_full_win), 2 },
+  },
+  [HAPTICS_MODE_REDUCED] = {
+    [GAME_VIBE_CORRECT] = { { NULL, 0 }, 0 },
+    [GAME_VIBE_WRONG] = { PATTERN(s_reduced_wrong), 2 },
+    [GAME_VIBE_ROUND] = { PATTERN(s_reduced_round), 1 },
+    [GAME_VIBE_MILESTONE] = { PATTERN(s_reduced_milestone), 1 },
+    [GAME_VIBE_FINAL] = { PATTERN(s_reduced_final), 1 },
+    [GAME_VIBE_WIN] = { PATTERN(s_reduced_win), 2 },
+  },
+};
+
+static uint32_t (*s_now_ms)(void);
+static HapticsMode s_mode = HAPTICS_MODE_FULL;
+static HapticsStats s_stats;
+static uint32_t s_busy_until_ms;  // end of the pattern last handed to the motor
+static uint8_t s_busy_priority;
+
+static bool motor_busy(uint32_t now) {
+  return (int32_t)(s_busy_until_ms - now) > 0;
+}
+
+void haptics_play(GameVibe event) {
+  if (event < 0 || event >= GAME_VIBE_COUNT) return;
+  const Haptic *haptic = &s_haptics[s_mode][event];
+  if (!haptic->pattern.num_segments) return;
+  uint32_t now = s_now_ms();
+  if (motor_busy(now)) {
+    if (haptic->priority <= s_busy_priority) {
+      // fast input: the last tick is still buzzing, another adds nothing
+      s_stats.dropped++;
+      return;
+    }
+    vibes_cancel();
+    s_stats.cancelled++;
+  }
+  uint32_t total_ms = 0;
+  for (uint32_t i = 0; i < haptic->pattern.num_segments; ++i) {
+    total_ms += haptic->pattern.durations[i];
+    if (i % 2 == 0) s_stats.motor_ms += haptic->pattern.durations[i];
+  }
+  vibes_enqueue_custom_pattern(haptic->pattern);
+  s_stats.played++;
+  s_busy_until_ms = now + total_ms;
+  s_busy_priority = haptic->priority;
+}
+
+void haptics_set_mode(HapticsMode mode) {
+  if (mode < 0 || mode >= HAPTICS_MODE_COUNT) return;
+  s_mode = mode;
+}
+
+HapticsMode haptics_get_mode(void) {
+  return s_mode;
+}
+
+const HapticsStats *haptics_get_stats(void) {
+  return &s_stats;
+}
+
+void haptics_init(uint32_t (*now_ms)(void)) {
+  s_now_ms = now_ms;
+  s_stats = (HapticsStats) { 0 };
+  s_busy_until_ms = now_ms();
+  s_busy_priority = 0;
+}
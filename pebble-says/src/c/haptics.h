@@ -0,0 +1,30 @@
+#pragma once
+
+// One precomputed vibe pattern per game event instead of stacked SDK
+// pulses. Each event maps to a const VibePattern, so a milestone is a
+// single motor command rather than a double pulse chased by a long one.
+// Correct-press ticks are dropped while the previous pattern is still
+// running; anything more important cancels it and takes over.
+
+#include <pebble.h>
+
+#include "game_core.h"
+
+typedef enum {
+  HAPTICS_MODE_FULL = 0,
+  HAPTICS_MODE_REDUCED,  // shorter patterns, no per-press ticks
+  HAPTICS_MODE_COUNT
+} HapticsMode;
+
+typedef struct {
+  uint32_t played;     // patterns handed to the motor
+  uint32_t dropped;    // ticks skipped while a pattern was running
+  uint32_t cancelled;  // patterns cut short by a more important one
+  uint32_t motor_ms;   // total on-time requested
+} HapticsStats;
+
+void haptics_init(uint32_t (*now_ms)(void));
+void haptics_play(GameVibe event);
+void haptics_set_mode(HapticsMode mode);
+HapticsMode haptics_get_mode(void);
+const HapticsStats *haptics_get_stats(void);
@@ -0,0 +1,56 @@
+#include "histogram.h"
+
+void histogram_init(Histogram *h, const uint16_t *bounds, int num_bounds) {
+  if (num_bounds > HISTOGRAM_MAX_BUCKETS - 1) num_bounds = HISTOGRAM_MAX_BUCKETS - 1;
+  if (num_bounds < 0) num_bounds = 0;
+  h->bounds = bounds;
+  h->buckets = (uint8_t)(num_bounds + 1);
+  histogram_clear(h);
+}
+
+void histogram_clear(Histogram *h) {
+  for (int i = 0; i < HISTOGRAM_MAX_BUCKETS; ++i) h->counts[i] = 0;
+  h->total = 0;
+  h->sum = 0;
+  h->min = UINT32_MAX;
+  h->max = 0;
+}
+
+void histogram_add(Histogram *h, uint32_t value) {
+  int b = 0;
+  // few buckets: a linear scan beats a binary search on the watch
+  while (b < h->buckets - 1 && value > h->bounds[b]) b++;
+  h->counts[b]++;
+  h->total++;
+  h->sum += value;
+  if (value < h->min) h->min = value;
+  if (value > h->max) h->max = value;
+}
+
+uint32_t histogram_percentile(const Histogram *h, int percent) {
+  if (!h->total) return 0;
+  if (percent <= 0) return h->min;
+  if (percent >= 100) return h->max;
+  // rank of the sample we want, 1-based, rounded up
+  uint32_t rank = (uint32_t)(((uint64_t)h->total * (uint32_t)percent + 99) / 100);
+  uint32_t seen = 0;
+  for (int b = 0; b < h->buckets; ++b) {
+    uint32_t count = h->counts[b];
+    if (seen + count < rank) {
+      seen += count;
+      continue;
+    }
+    // interpolate across the bucket, clamped to what was actually observed
+    uint32_t lo = b == 0 ? 0 : (uint32_t)h->bounds[b - 1] + 1;
+    uint32_t hi = b == h->buckets - 1 ? h->max : h->bounds[b];
+    if (lo < h->min) lo = h->min;
+    if (hi > h->max) hi = h->max;
+    if (hi <= lo) return lo;
+    return lo + (uint32_t)((uint64_t)(hi - lo) * (rank - seen) / count);
+  }
+  return h->max;
+}
+
+uint32_t histogram_mean(const Histogram *h) {
+  return h->total ? (uint32_t)(h->sum / h->total) : 0;
+}
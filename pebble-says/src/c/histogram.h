@@ -0,0 +1,29 @@
+#pragma once
+
+// Fixed-bucket histogram: bounded memory, no per-sample allocation, and
+// percentiles estimated from the bucket counts by interpolating inside the
+// bucket that holds the rank. Platform-free.
+
+#include <stdint.h>
+
+#define HISTOGRAM_MAX_BUCKETS 16
+
+typedef struct {
+  const uint16_t *bounds;  // ascending upper bounds; the last bucket is open-ended
+  uint8_t buckets;         // bounds + 1, at most HISTOGRAM_MAX_BUCKETS
+  uint32_t counts[HISTOGRAM_MAX_BUCKETS];
+  uint32_t total;
+  uint64_t sum;         // 64-bit so long host runs do not wrap
+  uint32_t min;
+  uint32_t max;
+} Histogram;
+
+// bounds must outlive the histogram (a const table); at most
+// HISTOGRAM_MAX_BUCKETS - 1 of them are used.
+void histogram_init(Histogram *h, const uint16_t *bounds, int num_bounds);
+void histogram_clear(Histogram *h);
+void histogram_add(Histogram *h, uint32_t value);
+
+// percent in 0..100; 0 when empty
+uint32_t histogram_percentile(const Histogram *h, int percent);
+uint32_t histogram_mean(const Histogram *h);
@@ -0,0 +1,136 @@
+#include "input.h"
+
+static Window *s_window;
+static InputHandler s_handler;
+static InputHandler s_long_handlers[NUM_BUTTONS];
+static bool (*s_long_armed[NUM_BUTTONS])(void);
+static uint32_t (*s_now_ms)(void);
+static InputMode s_mode = INPUT_MODE_DEFAULT;
+static InputStats s_stats;
+static uint32_t s_down_ms[NUM_BUTTONS];  // time of the last accepted press-down
+static bool s_held[NUM_BUTTONS];         // down seen, up not yet
+static bool s_deferred[NUM_BUTTONS];     // press mode: short or long, decided by the long press
+static bool s_reconfigure;               // subscriptions changed while a button was held
+
+static bool long_armed(ButtonId button) {
+  return s_long_handlers[button] && (!s_long_armed[button] || s_long_armed[button]());
+}
+
+static void deliver(ButtonId button) {
+  uint32_t latency = s_now_ms() - s_down_ms[button];
+  s_stats.presses++;
+  s_stats.last_latency_ms = latency;
+  s_stats.total_latency_ms += latency;
+  if (latency > s_stats.max_latency_ms) s_stats.max_latency_ms = latency;
+  s_handler(button);
+}
+
+static void raw_down_handler(ClickRecognizerRef recognizer, void *context) {
+  ButtonId button = click_recognizer_get_button_id(recognizer);
+  uint32_t now = s_now_ms();
+  // contact bounce: a second down without an up, or one right after the last
+  if (s_held[button] || now - s_down_ms[button] < INPUT_DEBOUNCE_MS) {
+    s_stats.debounced++;
+    return;
+  }
+  s_held[button] = true;
+  s_down_ms[button] = now;
+  if (s_mode != INPUT_MODE_RAW) return;
+  if (long_armed(button)) s_deferred[button] = true;
+  else deliver(button);
+}
+
+static void configure(void);
+
+static void raw_up_handler(ClickRecognizerRef recognizer, void *context) {
+  ButtonId button = click_recognizer_get_button_id(recognizer);
+  s_held[button] = false;
+  if (s_deferred[button]) {
+    // released before the long press fired: it was a short one
+    s_deferred[button] = false;
+    deliver(button);
+  }
+  if (s_reconfigure) configure();
+}
+
+static void single_click_handler(ClickRecognizerRef recognizer, void *context) {
+  deliver(click_recognizer_get_button_id(recognizer));
+}
+
+static void long_click_handler(ClickRecognizerRef recognizer, void *context) {
+  ButtonId button = click_recognizer_get_button_id(recognizer);
+  if (s_mode == INPUT_MODE_RAW) {
+    // only a press held back at its down can turn long; the others have acted
+    if (!s_deferred[button]) return;
+    s_deferred[button] = false;
+  } else if (!long_armed(button)) {
+    // the recognizer drops the single click once the long one fires
+    deliver(button);
+    return;
+  }
+  if (s_long_handlers[button]) s_long_handlers[button](button);
+}
+
+static void click_config_provider(void *context) {
+  static const ButtonId buttons[] = { BUTTON_ID_UP, BUTTON_ID_SELECT, BUTTON_ID_DOWN };
+  for (unsigned i = 0; i < sizeof(buttons) / sizeof(buttons[0]); ++i) {
+    window_raw_click_subscribe(buttons[i], raw_down_handler, raw_up_handler, NULL);
+    if (s_mode == INPUT_MODE_CLICK) {
+      window_single_click_subscribe(buttons[i], single_click_handler);
+    }
+    if (s_long_handlers[buttons[i]]) {
+      window_long_click_subscribe(buttons[i], INPUT_LONG_PRESS_MS, long_click_handler, NULL);
+    }
+  }
+}
+
+// Re-running the provider replaces every subscription and resets the
+// recognizers, which would lose a press in flight (its long press never
+// fires), so a change made during a press waits for the release.
+static void configure(void) {
+  if (!s_window) return;
+  for (int i = 0; i < NUM_BUTTONS; ++i) {
+    if (s_held[i]) {
+      s_reconfigure = true;
+      return;
+    }
+  }
+  s_reconfigure = false;
+  window_set_click_config_provider(s_window, click_config_provider);
+}
+
+void input_set_mode(InputMode mode) {
+  if (mode < 0 || mode >= INPUT_MODE_COUNT) return;
+  s_mode = mode;
+  configure();
+}
+
+void input_set_long_press_handler(ButtonId button, InputHandler handler, bool (*armed)(void)) {
+  if (button >= NUM_BUTTONS) return;
+  s_long_handlers[button] = handler;
+  s_long_armed[button] = armed;
+  configure();
+}
+
+InputMode input_get_mode(void) {
+  return s_mode;
+}
+
+const char *input_mode_name(InputMode mode) {
+  return mode == INPUT_MODE_RAW ? "press" : "click";
+}
+
+const InputStats *input_get_stats(void) {
+  return &s_stats;
+}
+
+void input_reset_stats(void) {
+  s_stats = (InputStats) { 0 };
+}
+
+void input_init(Window *window, InputHandler handler, uint32_t (*now_ms)(void)) {
+  s_window = window;
+  s_handler = handler;
+  s_now_ms = now_ms;
+  input_set_mode(s_mode);
+}
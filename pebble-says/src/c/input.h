@@ -0,0 +1,48 @@
+#pragma once
+
+// Button input with two selectable paths so input-to-feedback latency can
+// be A/B tested on a real watch:
+//   INPUT_MODE_CLICK  single-click recognizer, fires on release
+//   INPUT_MODE_RAW    raw handlers, fires on press-down with its own debounce
+// Raw down events are timestamped in both modes, so the delay between the
+// physical press and the action is measured either way.
+
+#include <pebble.h>
+
+#define INPUT_DEBOUNCE_MS 30
+#define INPUT_LONG_PRESS_MS 700
+
+typedef enum {
+  INPUT_MODE_CLICK = 0,
+  INPUT_MODE_RAW,
+  INPUT_MODE_COUNT
+} InputMode;
+
+#ifndef INPUT_MODE_DEFAULT
+#define INPUT_MODE_DEFAULT INPUT_MODE_CLICK
+#endif
+
+typedef struct {
+  uint32_t presses;           // actions delivered to the handler
+  uint32_t debounced;         // raw downs dropped as bounce
+  uint32_t last_latency_ms;   // physical press -> action
+  uint32_t max_latency_ms;
+  uint32_t total_latency_ms;
+} InputStats;
+
+typedef void (*InputHandler)(ButtonId button);
+
+void input_init(Window *window, InputHandler handler, uint32_t (*now_ms)(void));
+void input_set_mode(InputMode mode);
+InputMode input_get_mode(void);
+const char *input_mode_name(InputMode mode);
+
+// Optional long press of a button (debug tooling, replays); NULL
+// unsubscribes. armed says whether the long press means anything right now
+// (NULL: always). A press is either short or long, never both: click mode
+// gets that from the recognizer, and press mode holds an armed button's
+// short press until release. Disarmed buttons act on press-down as usual,
+// and a long hold of one is just that press.
+void input_set_long_press_handler(ButtonId button, InputHandler handler, bool (*armed)(void));
+const InputStats *input_get_stats(void);
+void input_reset_stats(void);
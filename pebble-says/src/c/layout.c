@@ -0,0 +1,86 @@
+#include "layout.h"
+
+// leave a right column for glyphs and place the text blocks to its left;
+// command text is exactly centered vertically, title above, info below
+#define LAYOUT_GLYPH_W 36
+#define LAYOUT_GLYPH_H 30
+#define LAYOUT_TEXT_H 44    // GOTHIC_28_BOLD block height
+#define LAYOUT_TITLE_H 34   // GOTHIC_28_BOLD title
+#define LAYOUT_GAP 6        // spacing between elements
+#define LAYOUT_INFO_H(state) ((state) == LAYOUT_STATE_PLAYING ? 28 : 44) // two lines between games
+
+#define LAYOUT_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define LAYOUT_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+#define LAYOUT_TEXT_Y(h) ((h) / 2 - LAYOUT_TEXT_H / 2)
+#define LAYOUT_TITLE_Y(h) LAYOUT_MAX(LAYOUT_TEXT_Y(h) - LAYOUT_TITLE_H - LAYOUT_GAP, 0)
+#define LAYOUT_INFO_Y(h, state) \
+  LAYOUT_MIN(LAYOUT_TEXT_Y(h) + LAYOUT_TEXT_H + LAYOUT_GAP, (h) - LAYOUT_INFO_H(state))
+
+#define LAYOUT_RECT(x, y, w, h) { { (x), (y) }, { (w), (h) } }
+
+// glyphs sit beside the Up/Select/Down buttons
+#define LAYOUT_INIT(w, h, state) { \
+  .title = LAYOUT_RECT(0, LAYOUT_TITLE_Y(h), (w) - LAYOUT_GLYPH_W, LAYOUT_TITLE_H), \
+  .message = LAYOUT_RECT(0, LAYOUT_TEXT_Y(h), (w) - LAYOUT_GLYPH_W, LAYOUT_TEXT_H), \
+  .info = LAYOUT_RECT(0, LAYOUT_INFO_Y(h, state), (w) - LAYOUT_GLYPH_W, LAYOUT_INFO_H(state)), \
+  .glyphs = { \
+    LAYOUT_RECT((w) - LAYOUT_GLYPH_W, 24, LAYOUT_GLYPH_W, LAYOUT_GLYPH_H), \
+    LAYOUT_RECT((w) - LAYOUT_GLYPH_W, (h) / 2 - LAYOUT_GLYPH_H / 2, LAYOUT_GLYPH_W, LAYOUT_GLYPH_H), \
+    LAYOUT_RECT((w) - LAYOUT_GLYPH_W, (h) - 50, LAYOUT_GLYPH_W, LAYOUT_GLYPH_H), \
+  }, \
+}
+
+#ifdef PBL_ROUND
+// Text is centred inside the glyph ring; each glyph's letter box sits on
+// the ring's mid radius at its segment angle. Sines are per mille so the
+// tables stay compile-time constants.
+#define LAYOUT_ARC_R(w) ((w) / 2 - LAYOUT_RING_W / 2)
+#define LAYOUT_ARC_BOX(w, h, sin_pm, cos_pm) LAYOUT_RECT( \
+  (w) / 2 + LAYOUT_ARC_R(w) * (sin_pm) / 1000 - LAYOUT_RING_W / 2, \
+  (h) / 2 - LAYOUT_ARC_R(w) * (cos_pm) / 1000 - LAYOUT_RING_W / 2, LAYOUT_RING_W, LAYOUT_RING_W)
+
+#define LAYOUT_INIT_ROUND(w, h, state) { \
+  .title = LAYOUT_RECT(LAYOUT_RING_W, LAYOUT_TITLE_Y(h), (w) - 2 * LAYOUT_RING_W, LAYOUT_TITLE_H), \
+  .message = LAYOUT_RECT(LAYOUT_RING_W, LAYOUT_TEXT_Y(h), (w) - 2 * LAYOUT_RING_W, LAYOUT_TEXT_H), \
+  .info = LAYOUT_RECT(LAYOUT_RING_W, LAYOUT_INFO_Y(h, state), (w) - 2 * LAYOUT_RING_W, LAYOUT_INFO_H(state)), \
+  .glyphs = { \
+    LAYOUT_ARC_BOX(w, h, 707, 707),   /* 45 deg */ \
+    LAYOUT_ARC_BOX(w, h, 1000, 0),    /* 90 deg */ \
+    LAYOUT_ARC_BOX(w, h, 707, -707),  /* 135 deg */ \
+  }, \
+}
+#undef LAYOUT_INIT
+#define LAYOUT_INIT LAYOUT_INIT_ROUND
+#endif
+
+// screen size of the platform being built (targetPlatforms in package.json)
+#if defined(PBL_PLATFORM_EMERY)
+#define LAYOUT_SCREEN_W 200
+#define LAYOUT_SCREEN_H 228
+#elif defined(PBL_PLATFORM_CHALK)
+#define LAYOUT_SCREEN_W 180
+#define LAYOUT_SCREEN_H 180
+#else  // aplite, basalt, diorite
+#define LAYOUT_SCREEN_W 144
+#define LAYOUT_SCREEN_H 168
+#endif
+
+static const Layout s_layouts[LAYOUT_STATE_COUNT] = {
+  [LAYOUT_STATE_TITLE] = LAYOUT_INIT(LAYOUT_SCREEN_W, LAYOUT_SCREEN_H, LAYOUT_STATE_TITLE),
+  [LAYOUT_STATE_PLAYING] = LAYOUT_INIT(LAYOUT_SCREEN_W, LAYOUT_SCREEN_H, LAYOUT_STATE_PLAYING),
+  [LAYOUT_STATE_GAME_OVER] = LAYOUT_INIT(LAYOUT_SCREEN_W, LAYOUT_SCREEN_H, LAYOUT_STATE_GAME_OVER),
+};
+
+const Layout *layout_get(LayoutState state, GSize size) {
+  if (state < 0 || state >= LAYOUT_STATE_COUNT) state = LAYOUT_STATE_PLAYING;
+  if (size.w == LAYOUT_SCREEN_W && size.h == LAYOUT_SCREEN_H) {
+    return &s_layouts[state];
+  }
+  // unknown bounds: same formula, evaluated now
+  static Layout s_computed;
+  const int w = size.w;
+  const int h = size.h;
+  s_computed = (Layout) LAYOUT_INIT(w, h, state);
+  return &s_computed;
+}
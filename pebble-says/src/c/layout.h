@@ -0,0 +1,37 @@
+#pragma once
+
+// Screen layouts for each game state. The frames for the current
+// platform's screen are built at compile time into a const table from the
+// same formula the runtime fallback uses, so the two cannot drift apart.
+// Only unknown bounds (e.g. an obstructed screen) are computed at runtime.
+
+#include <pebble.h>
+
+#define LAYOUT_GLYPHS 3
+
+#ifdef PBL_ROUND
+// Round screens put each glyph on a ring segment next to its button; the
+// segments are drawn by render.c from these constants.
+#define LAYOUT_RING_W 24       // ring width inside the bezel
+#define LAYOUT_ARC_HALF_DEG 20 // each segment spans its centre angle +- this
+// segment centres, degrees clockwise from 12 o'clock: Up, Select, Down
+#define LAYOUT_ARC_UP_DEG 45
+#define LAYOUT_ARC_SELECT_DEG 90
+#define LAYOUT_ARC_DOWN_DEG 135
+#endif
+
+typedef enum {
+  LAYOUT_STATE_TITLE = 0,  // first launch: title, "Press Select", modes
+  LAYOUT_STATE_PLAYING,
+  LAYOUT_STATE_GAME_OVER,
+  LAYOUT_STATE_COUNT
+} LayoutState;
+
+typedef struct {
+  GRect title;
+  GRect message;
+  GRect info;
+  GRect glyphs[LAYOUT_GLYPHS];
+} Layout;
+
+const Layout *layout_get(LayoutState state, GSize size);
@@ -0,0 +1,57 @@
+#include "memstats.h"
+
+#include "game_log.h"
+#include "trace.h"
+
+static MemStats s_stats;
+static uintptr_t s_stack_base;
+
+void memstats_init(const void *stack_base) {
+  s_stats = (MemStats) { .min_heap_free = UINT32_MAX };
+  s_stack_base = (uintptr_t)stack_base;
+}
+
+void memstats_sample(MemPoint point) {
+  if (point < 0 || point >= MEM_POINT_COUNT) return;
+  char here;
+  MemSample *sample = &s_stats.samples[point];
+  sample->taken = true;
+  sample->heap_used = heap_bytes_used();
+  sample->heap_free = heap_bytes_free();
+  // the stack grows down from main()
+  sample->stack_used = s_stack_base > (uintptr_t)&here ? s_stack_base - (uintptr_t)&here : 0;
+  if (sample->heap_used > s_stats.peak_heap_used) s_stats.peak_heap_used = sample->heap_used;
+  if (sample->heap_free < s_stats.min_heap_free) s_stats.min_heap_free = sample->heap_free;
+  if (sample->stack_used > s_stats.peak_stack_used) s_stats.peak_stack_used = sample->stack_used;
+  // trace arguments are 16 bits: heap figures in 4-byte units
+  GAME_TRACE(TRACE_EV_HEAP_USED, point, sample->heap_used / 4);
+  GAME_TRACE(TRACE_EV_HEAP_FREE, point, sample->heap_free / 4);
+}
+
+const MemStats *memstats_get(void) {
+  return &s_stats;
+}
+
+const char *memstats_point_name(MemPoint point) {
+  static const char *const names[MEM_POINT_COUNT] = {
+    [MEM_POINT_INIT] = "init",
+    [MEM_POINT_LOAD] = "load",
+    [MEM_POINT_FIRST_ROUND] = "first round",
+    [MEM_POINT_UNLOAD] = "unload",
+  };
+  if (point < 0 || point >= MEM_POINT_COUNT) return "?";
+  return names[point];
+}
+
+void memstats_log(void) {
+  for (int i = 0; i < MEM_POINT_COUNT; ++i) {
+    const MemSample *sample = &s_stats.samples[i];
+    if (!sample->taken) continue;
+    GAME_LOG_INFO("Mem %s: heap %lu used, %lu free, stack %lu", memstats_point_name((MemPoint)i),
+                  (unsigned long)sample->heap_used, (unsigned long)sample->heap_free,
+                  (unsigned long)sample->stack_used);
+  }
+  GAME_LOG_INFO("Mem peak: heap %lu used, %lu min free, stack %lu",
+                (unsigned long)s_stats.peak_heap_used, (unsigned long)s_stats.min_heap_free,
+                (unsigned long)s_stats.peak_stack_used);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// Heap and stack budget samples at fixed points of the app's life, so the
+// cost of the window's layers and buffers can be measured per platform
+// (aplite has the least app RAM). Each sample also goes to the trace ring.
+
+#include <pebble.h>
+
+typedef enum {
+  MEM_POINT_INIT = 0,     // before the window exists
+  MEM_POINT_LOAD,         // window loaded, layers created
+  MEM_POINT_FIRST_ROUND,  // first game started
+  MEM_POINT_UNLOAD,       // before the window's layers are destroyed
+  MEM_POINT_COUNT
+} MemPoint;
+
+typedef struct {
+  bool taken;
+  uint32_t heap_used;
+  uint32_t heap_free;
+  uint32_t stack_used;  // depth below main() at the sample point
+} MemSample;
+
+typedef struct {
+  MemSample samples[MEM_POINT_COUNT];
+  uint32_t peak_heap_used;
+  uint32_t min_heap_free;
+  uint32_t peak_stack_used;
+} MemStats;
+
+// stack_base is the address of a local in main(); stack growth is measured from it.
+void memstats_init(const void *stack_base);
+void memstats_sample(MemPoint point);
+const MemStats *memstats_get(void);
+const char *memstats_point_name(MemPoint point);
+
+// Logs every sample and the peaks (compiled out with logging).
+void memstats_log(void);
@@ -1,568 +1,841 @@
 #include <pebble.h>
-#include <stdlib.h>
 #include <stdint.h>
 #include <time.h>
 
-#define MAX_SEQUENCE 8
-#define SHOW_MS 700  // base show duration; will ramp down each round
-#define PAUSE_MS 300
-
-typedef enum {
-  SEQ_BTN_UP = 0,
-  SEQ_BTN_SELECT = 1,
-  SEQ_BTN_DOWN = 2
-} SequenceButton;
+#include "benchmark.h"
+#include "game_core.h"
+#include "game_log.h"
+#include "haptics.h"
+#include "input.h"
+#include "layout.h"
+#include "memstats.h"
+#include "persist_keys.h"
+#include "playback.h"
+#include "power.h"
+#include "profiler.h"
+#include "render.h"
+#include "replay.h"
+#include "scheduler.h"
+#include "stats.h"
+#include "telemetry.h"
+#include "trace.h"
 
 static Window *s_window;
-static TextLayer *s_text_layer;
-static TextLayer *s_info_layer;
-static TextLayer *s_glyph_layers[3];
-// Using simple letter glyphs (U/S/D) instead of icon overlay layers
-static TextLayer *s_title_layer; // title splash layer
-static Layer *s_flash_layer;     // full-screen flash/invert layer for celebrations
-
-static int s_sequence[MAX_SEQUENCE];
-static int s_seq_len = 0;
-static int s_input_index = 0;
-
-
-static bool s_showing = false;
-static int s_show_index = 0;
-static int s_show_phase = 0; // 0 = show, 1 = pause
-static AppTimer *s_sequence_timer = NULL;
-static AppTimer *s_feedback_timer = NULL;
-static AppTimer *s_transition_timer = NULL; // round completion animation timer
-static AppTimer *s_flash_timer = NULL;      // flash animation timer
-
-static bool s_game_over = false;
-static int s_round = 0;
-static bool s_transitioning = false; // block input during round-end animation
-static int s_show_ms_current = SHOW_MS;     // dynamically adjusted show time
+
+static AppTimer *s_sched_timer = NULL;                // single AppTimer backing the scheduler
+static SchedulerHandle s_game_timers[GAME_TIMER_COUNT]; // pending core timers
+static SchedulerHandle s_flash_timer;                   // flash animation tick
+
+static bool s_flashing = false;             // celebration flash in progress
 static int s_flash_phase = 0;               // flash animation phase counter
 static int s_flash_interval_ms = 150;       // per-tick interval for flash
+static GRect s_flash_region;                // screen area the flash covers
+static uint32_t s_sched_wakeups;            // scheduler AppTimer wakeups, for power accounting
+
+static uint32_t s_game_start_ms;            // for the telemetry duration
+static GameSnapshot s_resume;               // run interrupted by the last exit
+static bool s_resume_pending;               // read at init, resumed at load
+static bool s_snapshot_stored;              // a snapshot key exists in persist
+static uint32_t s_init_ms;                  // prv_init entry, for time-to-first-frame
+static uint32_t s_first_frame_ms;           // init -> end of the first update proc
+static bool s_game_ui_built;                // glyph column shown, info on
+
+// Playback of the last run's replay, long-press Down between games. It has
+// its own AppTimer so a recorded focus loss can pause the scheduler.
+static Replay s_playback;
+static ReplayCursor s_playback_cursor;
+static ReplayEvent s_playback_event;        // next event to feed
+static AppTimer *s_playback_timer;
+static uint32_t s_playback_start_ms;
+static bool s_replaying;                    // live buttons are ignored meanwhile
+
+_Static_assert(sizeof(Replay) <= (PERSIST_KEY_REPLAY_END - PERSIST_KEY_REPLAY) * PERSIST_DATA_MAX_LENGTH,
+               "replay doesn't fit its persist keys");
 
-static void schedule_sequence_timer(uint32_t ms);
-static void start_show_sequence(void *data);
-static void begin_round(void *data);
-static void apply_layout(void);
-static void highlight_glyph(int idx, bool on);
-static void clear_glyph_callback(void *data);
-static void sequence_timer_callback(void *data);
-static void clear_feedback_callback(void *data);
-static void start_round_transition(void);
-static void round_transition_callback(void *data);
-static void flash_layer_update_proc(Layer *layer, GContext *ctx);
-static void start_flash_animation(int cycles);
 static void flash_animation_tick(void *data);
-static int calc_show_ms(int len);
-
-static const char* button_name(int b) {
-  switch (b) {
-    case SEQ_BTN_UP: return "Up";
-    case SEQ_BTN_SELECT: return "Select";
-    case SEQ_BTN_DOWN: return "Down";
-    default: return "?";
-  }
-}
 
 static void show_message(const char *msg) {
-  text_layer_set_text(s_text_layer, msg);
+  render_set_message(msg);
+}
+
+static const char *mode_name(GameMode mode) {
+  return mode == GAME_MODE_ENDLESS ? "Endless" : "Classic";
+}
+
+// Everything the info text depends on; formatting is skipped when it matches
+typedef struct {
+  bool valid;
+  bool game_over;
+  bool fresh;  // no game played yet
+  GameMode mode;
+  InputMode input;
+  int round;
+  int best;
+  PowerSetting power;
+  bool power_saving;
+} InfoKey;
+
+static InfoKey s_info_key;
+
+// Title-screen token for the power setting (long-press Up between games);
+// NULL when there is nothing to say. It shares the input line, which only
+// has room for a couple of words in GOTHIC_18 on every layout.
+static const char *power_token(PowerSetting setting, bool saving) {
+  switch (setting) {
+    case POWER_SETTING_SAVER: return "saver";
+    case POWER_SETTING_FULL: return "full";
+    default: return saving ? "low batt" : NULL;
+  }
 }
 
 static void update_info_layer(void) {
   static char buf[48];
-  if (s_game_over) {
-    if (s_seq_len == 0) {
-      // Initial start screen: no duplicate 'Press Select'
-      buf[0] = '\0';
+  const GameState *game = game_get_state();
+  InfoKey key = {
+    .valid = true,
+    .game_over = game_is_over(game),
+    .fresh = game->seq_len == 0,
+    .mode = game->mode,
+    .input = input_get_mode(),
+    .round = game->round,
+    .best = stats_best(game->mode),
+    .power = power_get_setting(),
+    .power_saving = power_get_profile() == POWER_PROFILE_SAVER,
+  };
+  if (s_info_key.valid && key.game_over == s_info_key.game_over && key.fresh == s_info_key.fresh &&
+      key.mode == s_info_key.mode && key.input == s_info_key.input && key.round == s_info_key.round &&
+      key.best == s_info_key.best && key.power == s_info_key.power &&
+      key.power_saving == s_info_key.power_saving) {
+    return;
+  }
+  s_info_key = key;
+  if (key.game_over) {
+    if (game->seq_len == 0) {
+      // Initial start screen: no duplicate 'Press Select', just the modes (Up/Down toggle)
+      // second line: "Input: click", or "click \u00b7 saver" with a power token
+      char input[20];
+      const char *power = power_token(key.power, key.power_saving);
+      if (power) {
+        snprintf(input, sizeof(input), "%s \xc2\xb7 %s", input_mode_name(input_get_mode()), power);
+      } else {
+        snprintf(input, sizeof(input), "Input: %s", input_mode_name(input_get_mode()));
+      }
+      if (key.best > 0) {
+        snprintf(buf, sizeof(buf), "%s best: %d\n%s", mode_name(game->mode), key.best, input);
+      } else {
+        snprintf(buf, sizeof(buf), "Mode: %s\n%s", mode_name(game->mode), input);
+      }
     } else {
       // After a game has been played (loss or win): provide restart instructions
-      snprintf(buf, sizeof(buf), "Press Select to Restart\nRound: %d", s_round);
+      snprintf(buf, sizeof(buf), "Press Select to Restart\n%s round: %d", mode_name(game->mode), game->round);
     }
   } else {
-    snprintf(buf, sizeof(buf), "Round: %d", s_round);
+    snprintf(buf, sizeof(buf), "Round: %d", game->round);
+  }
+  render_set_info(buf);
+}
+
+static LayoutState current_layout_state(void) {
+  const GameState *game = game_get_state();
+  if (!game_is_over(game)) return LAYOUT_STATE_PLAYING;
+  return game->seq_len == 0 ? LAYOUT_STATE_TITLE : LAYOUT_STATE_GAME_OVER;
+}
+
+// Everything beyond the title screen, built by the first round rather than
+// before the first frame.
+static void build_game_ui(void) {
+  if (s_game_ui_built) return;
+  s_game_ui_built = true;
+  render_set_glyphs_visible(true);
+  render_set_info_visible(true);
+}
+
+static void set_layout_frames(const Layout *layout) {
+  render_set_frames(layout->title, layout->message, layout->info);
+  for (int i = 0; i < LAYOUT_GLYPHS; ++i) {
+    render_set_glyph_frame(i, layout->glyphs[i]);
   }
-  text_layer_set_text(s_info_layer, buf);
 }
 
+// the area a timeline quick view leaves uncovered
+static GRect layout_bounds(void) {
+#if PBL_API_EXISTS(layer_get_unobstructed_bounds)
+  return layer_get_unobstructed_bounds(window_get_root_layer(s_window));
+#else
+  return layer_get_bounds(window_get_root_layer(s_window));
+#endif
+}
+
+// the layout only depends on the screen size and the game state
+static bool s_layout_applied;  // cleared when frames were set some other way
+static LayoutState s_applied_state;
+static GSize s_applied_size;
+
 static void apply_layout(void) {
   if (!s_window) return;
-  Layer *window_layer = window_get_root_layer(s_window);
-  GRect bounds = layer_get_bounds(window_layer);
-  int glyph_w = 36;
-  int usable_w = bounds.size.w - glyph_w;
-  // Goal: command text (s_text_layer) exactly centered vertically; title above; info below.
-  const int text_h = 44;     // GOTHIC_28_BOLD block height
-  const int title_h = 34;    // GOTHIC_28_BOLD title
-  const int gap = 6;         // spacing between elements
-  bool initial_screen = (s_game_over && s_seq_len == 0);
-  const int info_h = (s_game_over && !initial_screen) ? 44 : 28; // larger only when showing restart info
-
-  const int center_y = bounds.size.h / 2;
-  int text_y = center_y - text_h / 2;
-  int title_y = text_y - title_h - gap;
-  if (title_y < 0) title_y = 0; // clamp to screen top
-  int info_y = text_y + text_h + gap;
-  if (info_y + info_h > bounds.size.h) {
-    // Clamp info to bottom if needed
-    info_y = bounds.size.h - info_h;
-  }
+  GRect bounds = layout_bounds();
+  LayoutState state = current_layout_state();
+  if (state == LAYOUT_STATE_PLAYING) build_game_ui();
+  if (s_layout_applied && state == s_applied_state && gsize_equal(&bounds.size, &s_applied_size)) return;
+  s_layout_applied = true;
+  s_applied_state = state;
+  s_applied_size = bounds.size;
+  set_layout_frames(layout_get(state, bounds.size));
+}
+
+static void highlight_glyph(int idx, bool on) {
+  render_set_glyph(idx, on);
+}
 
-  layer_set_frame(text_layer_get_layer(s_text_layer), GRect(0, text_y, usable_w, text_h));
-  text_layer_set_text_alignment(s_text_layer, GTextAlignmentCenter);
+static uint32_t prv_now_ms(void) {
+  time_t sec;
+  uint16_t ms;
+  time_ms(&sec, &ms);
+  return (uint32_t)sec * 1000 + ms;
+}
 
-  if (s_title_layer) {
-    layer_set_frame(text_layer_get_layer(s_title_layer), GRect(0, title_y, usable_w, title_h));
-    text_layer_set_text_alignment(s_title_layer, GTextAlignmentCenter);
+static void sched_timer_callback(void *data) {
+  // this is the only real timer; once it fires there is nothing to cancel
+  s_sched_timer = NULL;
+  s_sched_wakeups++;
+  PROFILE_BEGIN(start);
+  // every callback due in this wakeup lands in one render commit
+  render_hold();
+  scheduler_dispatch();
+  render_release();
+  PROFILE_END(PROFILE_TIMER, start);
+}
+
+static void sched_arm(uint32_t delay_ms) {
+  if (s_sched_timer && app_timer_reschedule(s_sched_timer, delay_ms)) return;
+  s_sched_timer = app_timer_register(delay_ms, sched_timer_callback, NULL);
+}
+
+static void sched_disarm(void) {
+  if (s_sched_timer) {
+    app_timer_cancel(s_sched_timer);
+    s_sched_timer = NULL;
   }
+}
+
+static const SchedulerBackend s_sched_backend = {
+  .now_ms = prv_now_ms,
+  .arm = sched_arm,
+  .disarm = sched_disarm,
+};
 
-  layer_set_frame(text_layer_get_layer(s_info_layer), GRect(0, info_y, usable_w, info_h));
-  text_layer_set_text_alignment(s_info_layer, GTextAlignmentCenter);
-  layer_set_hidden(text_layer_get_layer(s_info_layer), initial_screen); // hide info on initial screen
+static void game_timer_callback(void *data) {
+  game_timer_fired((GameTimer)(intptr_t)data);
+}
+
+static void sequence_edge(void) {
+  PROFILE_BEGIN(start);
+  game_timer_fired(GAME_TIMER_SEQUENCE);
+  PROFILE_END(PROFILE_EDGE, start);
+}
+
+static void cancel_game_timer(GameTimer timer) {
+  if (timer == GAME_TIMER_SEQUENCE) {
+    playback_cancel();
+    return;
+  }
+  scheduler_cancel(&s_game_timers[timer]);
 }
 
-static void add_random_step(void) {
-  if (s_seq_len < MAX_SEQUENCE) {
-    s_sequence[s_seq_len++] = rand() % 3;
-    APP_LOG(APP_LOG_LEVEL_INFO, "Added step %d (len=%d)", s_sequence[s_seq_len-1], s_seq_len);
+static void schedule_game_timer(GameTimer timer, uint32_t ms) {
+  if (timer == GAME_TIMER_SEQUENCE) {
+    // show/pause edges are frame-locked by the playback engine
+    playback_schedule(ms);
+    return;
   }
+  // same callback + data coalesces, so re-scheduling just moves the deadline
+  s_game_timers[timer] = scheduler_add(ms, game_timer_callback, (void*)(intptr_t)timer);
+}
+
+// Flash state per phase, fixed at compile time: colour alternates invert
+// and a warm tint, 1-bit inverts every other phase. Milestone rounds (more
+// cycles) flash the whole screen, ordinary rounds just the glyph column.
+static const FlashFxMode s_flash_cycle[] = {
+#ifdef PBL_COLOR
+  FLASH_FX_INVERT, FLASH_FX_NONE, FLASH_FX_TINT, FLASH_FX_NONE,
+#else
+  FLASH_FX_INVERT, FLASH_FX_NONE,
+#endif
+};
+
+static void apply_flash_phase(void) {
+  FlashFxMode mode = s_flashing ? s_flash_cycle[s_flash_phase % ARRAY_LENGTH(s_flash_cycle)] : FLASH_FX_NONE;
+  render_set_flash(mode, s_flash_region);
+}
+
+// A round ends with its celebration or with the game; charge it everything
+// since the previous one.
+static void prv_round_end(void) {
+  power_round_end(game_get_state()->round, s_sched_wakeups + playback_frame_count(),
+                  render_get_stats()->frames);
+}
+
+static void start_flash_animation(int cycles) {
+  prv_round_end();
+  const PowerPolicy *policy = power_get_policy();
+  s_flashing = true;
+  s_flash_phase = 0;
+  // platform-specific timing tweak (Chalk slower for round face aesthetics)
+#ifdef PBL_PLATFORM_CHALK
+  s_flash_interval_ms = 180;
+#else
+  s_flash_interval_ms = 140;
+#endif
+  if (policy->flash_tick_ms) s_flash_interval_ms = policy->flash_tick_ms;
+  s_flash_region = cycles > 3 && policy->full_screen_flash ? layer_get_bounds(window_get_root_layer(s_window))
+                                                           : render_get_glyph_column();
+  if (cycles > policy->max_flash_cycles) cycles = policy->max_flash_cycles;
+  apply_flash_phase();
+  s_flash_timer = scheduler_add(s_flash_interval_ms, flash_animation_tick, (void*)(intptr_t)cycles);
+}
+
+static void stop_flash_animation(void) {
+  scheduler_cancel(&s_flash_timer);
+  s_flashing = false;
+  s_flash_phase = 0;
+  apply_flash_phase();
 }
 
-static int calc_show_ms(int len) {
-  // Steeper early, gentler later; floor at 200ms
-  int ms;
-  if (len <= 1) ms = SHOW_MS;
-  else if (len <= 3) ms = SHOW_MS - 60 * (len - 1);
-  else ms = SHOW_MS - 60 * 2 - 35 * (len - 3);
-  if (ms < 200) ms = 200;
-  return ms;
-}
-
-static void begin_round(void *data) {
-  s_input_index = 0;
-  s_show_index = 0;
-  s_show_phase = 0;
-  s_showing = true;
-  s_game_over = false;
-  s_transitioning = false;
-  s_round = s_seq_len;
-  // speed ramp with piecewise curve
-  s_show_ms_current = calc_show_ms(s_seq_len);
+static void flash_animation_tick(void *data) {
+  int cycles = (int)(intptr_t)data;
+  s_flash_phase++;
+  apply_flash_phase();
+  if (s_flash_phase >= cycles) return; // done
+  s_flash_timer = scheduler_add(s_flash_interval_ms, flash_animation_tick, (void*)(intptr_t)cycles);
+}
+
+static void game_finished(bool won) {
+  prv_round_end();
+  // RAM only; the telemetry batch and the stats write go out from timers
+  // once the result is showing
+  if (s_replaying) return;  // a replayed run already counted when it was played
+  telemetry_record_game(game_get_state(), won, prv_now_ms() - s_game_start_ms);
+  telemetry_set_playing(false);
+  stats_record_game(game_get_state(), won);
+  stats_schedule_write();
+}
+
+static const GamePlatform s_platform = {
+  .show_message = show_message,
+  .highlight_glyph = highlight_glyph,
+  .update_info = update_info_layer,
+  .apply_layout = apply_layout,
+  .vibe = haptics_play,
+  .start_celebration = start_flash_animation,
+  .stop_celebration = stop_flash_animation,
+  .schedule_timer = schedule_game_timer,
+  .cancel_timer = cancel_game_timer,
+  .now_ms = playback_now_ms,
+  .reports_edge_shown = true,
+  .game_finished = game_finished,
+};
+
+static void toggle_mode(void) {
+  const GameState *game = game_get_state();
+  game_set_mode(game->mode == GAME_MODE_ENDLESS ? GAME_MODE_CLASSIC : GAME_MODE_ENDLESS);
   update_info_layer();
-  APP_LOG(APP_LOG_LEVEL_INFO, "Begin round %d (seq_len=%d, show_ms=%d)", s_round, s_seq_len, s_show_ms_current);
-  // start showing immediately
-  start_show_sequence(NULL);
-  apply_layout();
 }
 
-static void end_game(void) {
-  s_game_over = true;
-  s_showing = false;
-  if (s_sequence_timer) {
-    app_timer_cancel(s_sequence_timer);
-    s_sequence_timer = NULL;
+static void toggle_input_mode(void) {
+  const InputStats *stats = input_get_stats();
+  if (stats->presses) {
+    GAME_LOG_INFO("Input %s: %lu presses, avg %lu ms, max %lu ms press->action",
+            input_mode_name(input_get_mode()), (unsigned long)stats->presses,
+            (unsigned long)(stats->total_latency_ms / stats->presses), (unsigned long)stats->max_latency_ms);
   }
-  APP_LOG(APP_LOG_LEVEL_INFO, "Game over at round %d, seq_len=%d", s_round, s_seq_len);
+  input_set_mode(input_get_mode() == INPUT_MODE_RAW ? INPUT_MODE_CLICK : INPUT_MODE_RAW);
+  input_reset_stats();
   update_info_layer();
-  show_message("Game Over");
-  apply_layout();
 }
 
-static void sequence_timer_callback(void *data) {
-  // The timer that invoked this callback has now expired; clear the handle
-  // so we don't try to cancel an already-fired timer later (which logs warnings).
-  s_sequence_timer = NULL;
-  if (!s_showing) return;
+// bookkeeping around the start of a run, from Select or a resumed snapshot
+static void prv_game_starting(void) {
+  s_game_start_ms = prv_now_ms();
+  telemetry_set_playing(true);
+  stats_cancel_write();
+}
 
-  if (s_show_index >= s_seq_len) {
-    // finished showing
-    s_showing = false;
-    // clear any highlighted glyphs
-    for (int i = 0; i < 3; ++i) highlight_glyph(i, false);
-    show_message("Your turn");
-    return;
+static void prv_game_started(void) {
+  if (!memstats_get()->samples[MEM_POINT_FIRST_ROUND].taken) {
+    memstats_sample(MEM_POINT_FIRST_ROUND);
   }
+}
 
-  if (s_show_phase == 0) {
-    // show current step
-    int step = s_sequence[s_show_index];
-    show_message(button_name(step));
-    // highlight shown glyph
-    highlight_glyph(step, true);
-    s_show_phase = 1;
-  schedule_sequence_timer(s_show_ms_current);
-  } else {
-    // pause between steps
-    show_message("");
-    // clear highlight for the step we just showed
-    int prev_step = s_sequence[s_show_index];
-    highlight_glyph(prev_step, false);
-    s_show_phase = 0;
-    s_show_index++;
-    schedule_sequence_timer(PAUSE_MS);
-  }
+static void prv_handle_button(ButtonId button) {
+  bool game_over = game_is_over(game_get_state());
+  // collect the press's UI changes and commit them once at the end
+  render_hold();
+  switch (button) {
+    case BUTTON_ID_SELECT:
+      if (game_over) prv_game_starting();
+      game_select();
+      if (game_over) prv_game_started();
+      break;
+    case BUTTON_ID_UP:
+      // between games Up picks the game mode and Down the input path; in play they are inputs
+      if (game_over) toggle_mode();
+      else game_press(SEQ_BTN_UP);
+      break;
+    case BUTTON_ID_DOWN:
+      if (game_over) toggle_input_mode();
+      else game_press(SEQ_BTN_DOWN);
+      break;
+    default:
+      break;
+  }
+  render_release();
+}
+
+static void prv_button_handler(ButtonId button) {
+  if (s_replaying) return;
+  PROFILE_BEGIN(start);
+  prv_handle_button(button);
+  PROFILE_END(PROFILE_INPUT, start);
 }
 
-static void schedule_sequence_timer(uint32_t ms) {
-  if (s_sequence_timer) {
-    app_timer_cancel(s_sequence_timer);
+/* Icon overlay drawing removed: using simple letters for glyphs. */
+
+#if GAME_TRACE_ENABLED
+static void trace_log_record(const TraceRecord *record, void *context) {
+  // times are relative to the oldest record so the columns stay short
+  uint32_t *base = context;
+  if (*base == UINT32_MAX) *base = record->t_ms;
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "+%lu %s %d %d", (unsigned long)(record->t_ms - *base),
+          trace_event_name(record->event), record->a, record->b);
+}
+
+// long press of Select between games dumps the trace ring, memory readout and timing
+// percentiles;
+// formatting only happens here
+static void prv_trace_dump(ButtonId button) {
+  uint32_t base = UINT32_MAX;
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Trace: %d records, %lu overwritten", trace_count(),
+          (unsigned long)trace_dropped());
+  trace_dump(trace_log_record, &base);
+  memstats_log();
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "First frame %lu ms after init", (unsigned long)s_first_frame_ms);
+  const Histogram *reaction = game_get_reaction_histogram();
+  const Histogram *round = game_get_round_histogram();
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Reaction p50 %lu p95 %lu ms (%lu); round p50 %lu p95 %lu ms (%lu)",
+          (unsigned long)histogram_percentile(reaction, 50), (unsigned long)histogram_percentile(reaction, 95),
+          (unsigned long)reaction->total, (unsigned long)histogram_percentile(round, 50),
+          (unsigned long)histogram_percentile(round, 95), (unsigned long)round->total);
+  // the last run, as hex for host/replay -f
+  const Replay *replay = replay_get();
+  const uint8_t *bytes = (const uint8_t *)replay;
+  uint32_t size = replay->version == REPLAY_VERSION ? replay_size(replay) : 0;
+  for (uint32_t off = 0; off < size; off += 32) {
+    char hex[65];
+    uint32_t n = size - off < 32 ? size - off : 32;
+    for (uint32_t i = 0; i < n; ++i) snprintf(hex + 2 * i, 3, "%02x", bytes[off + i]);
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Replay %s", hex);
+  }
+  const HapticsStats *haptics = haptics_get_stats();
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Haptics %lu played, %lu dropped, %lu cancelled, %lu ms on",
+          (unsigned long)haptics->played, (unsigned long)haptics->dropped,
+          (unsigned long)haptics->cancelled, (unsigned long)haptics->motor_ms);
+  for (int profile = 0; profile < POWER_PROFILE_COUNT; ++profile) {
+    const PowerStats *power = power_get_stats((PowerProfile)profile);
+    if (!power->rounds) continue;
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Power %s: %lu rounds, %lu wakeups, %lu redraws per round",
+            power_profile_name((PowerProfile)profile), (unsigned long)power->rounds,
+            (unsigned long)(power->wakeups / power->rounds), (unsigned long)(power->redraws / power->rounds));
   }
-  s_sequence_timer = app_timer_register(ms, sequence_timer_callback, NULL);
 }
+#endif
 
-static void start_show_sequence(void *data) {
-  // Disable input while showing
-  s_showing = true;
-  s_show_index = 0;
-  s_show_phase = 0;
-  s_transitioning = false; // ensure not in transition
-  // Drop any stale handle left over from prior rounds to avoid cancel warnings
-  s_sequence_timer = NULL;
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "Starting to show sequence (len=%d, show_ms=%d)", s_seq_len, s_show_ms_current);
-  sequence_timer_callback(NULL);
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+// A quick-view animation resolves its two end layouts once, in
+// will_change: the table or the runtime fallback for the start and the
+// final uncovered area. Each change tick only interpolates between them,
+// and the renderer repaints just the frames that moved, in one commit per
+// tick. did_change lays out the final area exactly.
+static Layout s_unobstructed_from;
+static Layout s_unobstructed_to;
+static LayoutState s_unobstructed_state;
+static bool s_unobstructed_animating;
+
+static int16_t lerp(int16_t from, int16_t to, AnimationProgress progress) {
+  return (int16_t)(from + (int32_t)(to - from) * (int32_t)progress / ANIMATION_NORMALIZED_MAX);
 }
 
-static void clear_feedback_callback(void *data) {
-  // after brief "Good" feedback, prompt the player for the next input
-  show_message("Your turn");
+static GRect lerp_rect(GRect from, GRect to, AnimationProgress progress) {
+  return GRect(lerp(from.origin.x, to.origin.x, progress), lerp(from.origin.y, to.origin.y, progress),
+               lerp(from.size.w, to.size.w, progress), lerp(from.size.h, to.size.h, progress));
 }
 
-static void highlight_glyph(int idx, bool on) {
-  if (idx < 0 || idx > 2) return;
-  if (!s_glyph_layers[idx]) return;
-  // set highlight colors for letter glyphs
-  #ifdef PBL_COLOR
-  GColor base;
-  switch(idx) {
-    case 0: base = GColorRed; break;
-    case 1: base = GColorBlue; break;
-    case 2: base = GColorIslamicGreen; break;
-    default: base = GColorDarkGray; break;
-  }
-  if (on) {
-    text_layer_set_background_color(s_glyph_layers[idx], base);
-    text_layer_set_text_color(s_glyph_layers[idx], GColorWhite);
-  } else {
-    text_layer_set_background_color(s_glyph_layers[idx], GColorClear);
-    text_layer_set_text_color(s_glyph_layers[idx], base);
-  }
-  #else
-  if (on) {
-    text_layer_set_background_color(s_glyph_layers[idx], GColorBlack);
-    text_layer_set_text_color(s_glyph_layers[idx], GColorWhite);
+static void prv_unobstructed_will_change(GRect final_unobstructed_screen_area, void *context) {
+  if (!s_window) return;
+  LayoutState state = current_layout_state();
+  if (state == LAYOUT_STATE_PLAYING) build_game_ui();
+  // layout_get hands back a shared buffer for computed layouts: copy each
+  s_unobstructed_from = *layout_get(state, layout_bounds().size);
+  s_unobstructed_to = *layout_get(state, final_unobstructed_screen_area.size);
+  s_unobstructed_state = state;
+  s_unobstructed_animating = true;
+}
+
+static void prv_unobstructed_change(AnimationProgress progress, void *context) {
+  render_hold();
+  if (!s_unobstructed_animating || current_layout_state() != s_unobstructed_state) {
+    // the game moved on mid-animation: lay out the current height directly
+    apply_layout();
   } else {
-    text_layer_set_background_color(s_glyph_layers[idx], GColorClear);
-    text_layer_set_text_color(s_glyph_layers[idx], GColorBlack);
+    const Layout *from = &s_unobstructed_from;
+    const Layout *to = &s_unobstructed_to;
+    Layout frames = {
+      .title = lerp_rect(from->title, to->title, progress),
+      .message = lerp_rect(from->message, to->message, progress),
+      .info = lerp_rect(from->info, to->info, progress),
+    };
+    for (int i = 0; i < LAYOUT_GLYPHS; ++i) {
+      frames.glyphs[i] = lerp_rect(from->glyphs[i], to->glyphs[i], progress);
+    }
+    set_layout_frames(&frames);
+    s_layout_applied = false;
   }
-  #endif
+  render_release();
 }
 
-static void clear_glyph_callback(void *data) {
-  int idx = (int)(intptr_t)data;
-  highlight_glyph(idx, false);
-  s_feedback_timer = NULL;
+static void prv_unobstructed_did_change(void *context) {
+  s_unobstructed_animating = false;
+  render_hold();
+  apply_layout();
+  render_release();
 }
+#endif
 
-static void start_round_transition(void) {
-  s_transitioning = true;
-  s_showing = false;
-  // base vibration
-  vibes_double_pulse();
-  // milestone extra pulses
-  if (s_seq_len == 4 || s_seq_len == 6) {
-    vibes_short_pulse();
-  } else if (s_seq_len == 8) {
-    vibes_long_pulse();
-  }
-  static char buf[32];
-  snprintf(buf, sizeof(buf), "Length %d", s_seq_len); // center celebration text
-  show_message(buf);
-  // start flash animation (more cycles for milestones)
-  int cycles = (s_seq_len == 4 || s_seq_len == 6) ? 5 : (s_seq_len == 8 ? 7 : 3);
-  start_flash_animation(cycles);
-  if (s_transition_timer) {
-    app_timer_cancel(s_transition_timer);
-  }
-  // slightly longer than flash cycles to allow finish before next round
-  int duration = 150 * cycles + 200;
-  s_transition_timer = app_timer_register(duration, round_transition_callback, NULL);
+// A notification or other modal is about to cover the app: freeze every
+// deadline (game timers, flash ticks, telemetry and stats writes) so
+// nothing wakes up to draw frames nobody sees.
+static void prv_will_focus(bool in_focus) {
+  if (in_focus) return;
+  render_hold();
+  game_focus_lost();
+  scheduler_pause();
+  render_release();
 }
 
-static void round_transition_callback(void *data) {
-  s_transition_timer = NULL;
-  // ensure flash ends
-  if (s_flash_timer) {
-    app_timer_cancel(s_flash_timer);
-    s_flash_timer = NULL;
-  }
-  s_flash_phase = 0;
-  layer_mark_dirty(s_flash_layer);
-  begin_round(NULL);
+static void prv_did_focus(bool in_focus) {
+  if (!in_focus) return;
+  scheduler_resume();
+  render_hold();
+  game_focus_regained();
+  // the modal drew over the framebuffer
+  render_invalidate();
+  render_release();
 }
 
-static void handle_input(int pressed) {
-  if (s_showing) {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Input ignored while showing: %d", pressed);
-    return; // ignore input while showing
-  }
-  if (s_transitioning) {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Input ignored during transition: %d", pressed);
-    return; // ignore input during round-end transition
+static void prv_save_replay(void) {
+  const Replay *replay = replay_get();
+  if (replay->version != REPLAY_VERSION) return;  // nothing played this session
+  const uint8_t *bytes = (const uint8_t *)replay;
+  uint32_t size = replay_size(replay);
+  uint32_t key = PERSIST_KEY_REPLAY;
+  for (uint32_t off = 0; off < size; off += PERSIST_DATA_MAX_LENGTH) {
+    uint32_t chunk = size - off < PERSIST_DATA_MAX_LENGTH ? size - off : PERSIST_DATA_MAX_LENGTH;
+    persist_write_data(key++, bytes + off, chunk);
   }
-  if (s_game_over) {
-    // only Select restarts
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Input ignored - game over: %d", pressed);
-    return;
+}
+
+// This session's run if there was one, otherwise the one saved last time.
+static bool prv_load_replay(Replay *out) {
+  const Replay *recorded = replay_get();
+  if (recorded->version == REPLAY_VERSION) {
+    memcpy(out, recorded, replay_size(recorded));
+    return replay_valid(out);
+  }
+  uint8_t *bytes = (uint8_t *)out;
+  const uint32_t header = sizeof(Replay) - REPLAY_ARENA_BYTES;
+  uint32_t size = header;
+  uint32_t key = PERSIST_KEY_REPLAY;
+  for (uint32_t off = 0; off < size; off += PERSIST_DATA_MAX_LENGTH) {
+    uint32_t chunk = size - off < PERSIST_DATA_MAX_LENGTH ? size - off : PERSIST_DATA_MAX_LENGTH;
+    if (off == 0) chunk = PERSIST_DATA_MAX_LENGTH;  // header and the start of the data
+    int read = persist_read_data(key++, bytes + off, chunk);
+    if (read <= 0) return false;
+    if (off == 0) {
+      if ((uint32_t)read < header || out->length > REPLAY_ARENA_BYTES) return false;
+      size = replay_size(out);
+      if ((uint32_t)read < chunk && (uint32_t)read < size) return false;
+    }
   }
+  return replay_valid(out);
+}
 
-  if (s_input_index >= s_seq_len) {
-    APP_LOG(APP_LOG_LEVEL_DEBUG, "Input ignored - index >= seq_len: idx=%d len=%d", s_input_index, s_seq_len);
-    return;
+static void prv_playback_finish(void) {
+  s_replaying = false;
+  replay_set_recording(true);
+  const GameState *game = game_get_state();
+  GAME_LOG_INFO("Replay done at length %d (recorded %d)", game->seq_len, s_playback.end_len);
+#if BENCH_ENABLED
+  bench_report(&s_playback, game->seq_len);
+#endif
+  if (!game_is_over(game)) {
+    // the recording stopped mid-run: the player carries on from here
+    prv_game_starting();
   }
+}
 
-  APP_LOG(APP_LOG_LEVEL_INFO, "Button pressed: %d, expecting: %d (idx=%d)", pressed, s_sequence[s_input_index], s_input_index);
+static void prv_playback_tick(void *data);
 
-  // visual/vibe feedback for press
-  highlight_glyph(pressed, true);
-  if (s_feedback_timer) {
-    app_timer_cancel(s_feedback_timer);
-    s_feedback_timer = NULL;
+static void prv_playback_arm(void) {
+  if (!replay_next(&s_playback_cursor, &s_playback_event)) {
+    prv_playback_finish();
+    return;
   }
-  s_feedback_timer = app_timer_register(150, clear_glyph_callback, (void*)(intptr_t)pressed);
-
-  if (pressed == s_sequence[s_input_index]) {
-    // correct
-    vibes_short_pulse();
-    s_input_index++;
-    APP_LOG(APP_LOG_LEVEL_INFO, "Correct press, new input_index=%d", s_input_index);
-    if (s_input_index == s_seq_len) {
-      // completed round
-      if (s_seq_len >= MAX_SEQUENCE) {
-        // won at max length
-        s_game_over = true;
-        update_info_layer();
-        show_message("You win!");
-        APP_LOG(APP_LOG_LEVEL_INFO, "Player won at max sequence length %d", s_seq_len);
-      } else {
-        // prepare next round
-        add_random_step();
-        s_round = s_seq_len;
-        update_info_layer();
-  APP_LOG(APP_LOG_LEVEL_INFO, "Round complete, starting transition (len=%d)", s_seq_len);
-  // visual confirmation for end of round
-  start_round_transition();
-      }
-    } else {
-      // prompt for next input
-      show_message("Good");
-      // brief feedback, then restore the prompt without restarting the sequence
-      app_timer_register(200, (AppTimerCallback)clear_feedback_callback, NULL);
-    }
+  // absolute times, so one late callback doesn't shift the rest of the run
+  int32_t delay = (int32_t)(s_playback_start_ms + s_playback_event.at_ms - prv_now_ms());
+  s_playback_timer = app_timer_register(delay > 0 ? (uint32_t)delay : 0, prv_playback_tick, NULL);
+}
+
+static void prv_playback_tick(void *data) {
+  static const ButtonId buttons[] = {
+    [REPLAY_CODE_UP] = BUTTON_ID_UP,
+    [REPLAY_CODE_SELECT] = BUTTON_ID_SELECT,
+    [REPLAY_CODE_DOWN] = BUTTON_ID_DOWN,
+  };
+  s_playback_timer = NULL;
+#if BENCH_ENABLED
+  // presses the game acts on right away; queued ones only show up later
+  bench_replay_event(prv_now_ms() - (s_playback_start_ms + s_playback_event.at_ms),
+                     s_playback_event.code != REPLAY_CODE_EXT &&
+                     game_get_state()->phase == GAME_PHASE_INPUT);
+#endif
+  // the same paths the live press or focus change took
+  if (s_playback_event.code != REPLAY_CODE_EXT) {
+    prv_handle_button(buttons[s_playback_event.code]);
+  } else if (s_playback_event.ext == REPLAY_EXT_FOCUS_LOST) {
+    prv_will_focus(false);
   } else {
-    // wrong
-    vibes_long_pulse();
-    APP_LOG(APP_LOG_LEVEL_INFO, "Wrong press: %d (expected %d) at idx=%d", pressed, s_sequence[s_input_index], s_input_index);
-    end_game();
+    prv_did_focus(true);
   }
+  prv_playback_arm();
 }
 
-static void prv_select_click_handler(ClickRecognizerRef recognizer, void *context) {
-  if (s_game_over) {
-    // restart game - start at length 1 instead of 2
-    s_seq_len = 0;
-    s_round = 0;
-    add_random_step();
-    begin_round(NULL);
-    apply_layout();
+// Plays s_playback from its start.
+static void prv_playback_begin(void) {
+  GAME_LOG_INFO("Replaying seed %lu, %u events", (unsigned long)s_playback.seed, s_playback.events);
+  // play it back without recording over it
+  replay_set_recording(false);
+  s_replaying = true;
+  replay_cursor_init(&s_playback_cursor, &s_playback);
+  s_playback_start_ms = prv_now_ms();
+  render_hold();
+  bool started = game_start_replay(&s_playback);
+  render_release();
+  if (!started) {
+    prv_playback_finish();
     return;
   }
-  handle_input(SEQ_BTN_SELECT);
-}
-
-static void prv_up_click_handler(ClickRecognizerRef recognizer, void *context) {
-  handle_input(SEQ_BTN_UP);
+  prv_playback_arm();
 }
 
-static void prv_down_click_handler(ClickRecognizerRef recognizer, void *context) {
-  handle_input(SEQ_BTN_DOWN);
+static void prv_playback_start(ButtonId button) {
+  if (s_replaying || !game_is_over(game_get_state())) return;
+  if (!prv_load_replay(&s_playback)) {
+    GAME_LOG_INFO("No replay to play back");
+    return;
+  }
+  prv_playback_begin();
 }
 
-static void prv_click_config_provider(void *context) {
-  window_single_click_subscribe(BUTTON_ID_SELECT, prv_select_click_handler);
-  window_single_click_subscribe(BUTTON_ID_UP, prv_up_click_handler);
-  window_single_click_subscribe(BUTTON_ID_DOWN, prv_down_click_handler);
+#if BENCH_ENABLED
+static void prv_bench_start(void *data) {
+  if (s_replaying || !game_is_over(game_get_state())) return;
+  if (!bench_load_replay(&s_playback)) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "BENCH error embedded replay is invalid");
+    return;
+  }
+  prv_playback_begin();
 }
+#endif
 
-static void flash_layer_update_proc(Layer *layer, GContext *ctx) {
-  if (!s_transitioning) return; // only draw flashes during transition
-#ifdef PBL_COLOR
-  // alternate between white and yellow flashes on color devices
-  // subtle fade: draw translucent overlay depending on phase
-  int phase_mod = s_flash_phase % 4;
-  GColor col = (phase_mod < 2) ? GColorWhite : GColorYellow;
-  graphics_context_set_fill_color(ctx, col);
-  graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
-#else
-  // invert flash: fill white every other phase
-  if (s_flash_phase % 2 == 0) {
-    graphics_context_set_fill_color(ctx, GColorWhite);
-    graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+static void prv_playback_cancel(void) {
+  if (s_playback_timer) {
+    app_timer_cancel(s_playback_timer);
+    s_playback_timer = NULL;
   }
-#endif
+  s_replaying = false;
 }
 
-static void start_flash_animation(int cycles) {
-  s_flash_phase = 0;
-  // platform-specific timing tweak (Chalk slower for round face aesthetics)
-#ifdef PBL_PLATFORM_CHALK
-  s_flash_interval_ms = 180;
-#else
-  s_flash_interval_ms = 140;
+static void prv_after_first_frame(void *data) {
+  // neither is needed to draw the title, so both wait for it
+  telemetry_init();
+  stats_init();
+  update_info_layer();
+  render_set_info_visible(true);
+#if BENCH_ENABLED
+  // let the launch settle before the timed run
+  scheduler_add(BENCH_START_DELAY_MS, prv_bench_start, NULL);
 #endif
-  layer_mark_dirty(s_flash_layer);
-  if (s_flash_timer) {
-    app_timer_cancel(s_flash_timer);
-  }
-  s_flash_timer = app_timer_register(s_flash_interval_ms, flash_animation_tick, (void*)(intptr_t)cycles);
 }
 
-static void flash_animation_tick(void *data) {
-  int cycles = (int)(intptr_t)data;
-  s_flash_phase++;
-  layer_mark_dirty(s_flash_layer);
-  if (s_flash_phase >= cycles) {
-    s_flash_timer = NULL; // done
-    return;
-  }
-  s_flash_timer = app_timer_register(s_flash_interval_ms, flash_animation_tick, (void*)(intptr_t)cycles);
+static void prv_first_frame(void) {
+  s_first_frame_ms = prv_now_ms() - s_init_ms;
+  GAME_TRACE(TRACE_EV_FIRST_FRAME, 0, s_first_frame_ms > INT16_MAX ? INT16_MAX : s_first_frame_ms);
+  GAME_LOG_INFO("First frame %lu ms after init", (unsigned long)s_first_frame_ms);
+  // called from the update proc: build the rest outside the draw
+  scheduler_add(0, prv_after_first_frame, NULL);
 }
 
-/* Icon overlay drawing removed: using simple letters for glyphs. */
-
 static void prv_window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
+  // the renderer repaints only what changed, so the window must not clear the framebuffer
+  window_set_background_color(window, GColorClear);
+  render_init(window_layer, bounds);
+
+  // the first frame is just the title and "Press Select": the mode readout
+  // follows right after it, the glyph column with the first round
+  render_set_first_frame_handler(prv_first_frame);
+  render_set_info_visible(false);
+  render_set_title("Pebble Says");
+  render_set_message("Press Select");
+
+  // frames, glyphs included, come from the layout table
+  apply_layout();
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+  unobstructed_area_service_subscribe((UnobstructedAreaHandlers) {
+    .will_change = prv_unobstructed_will_change,
+    .change = prv_unobstructed_change,
+    .did_change = prv_unobstructed_did_change,
+  }, NULL);
+#endif
+  app_focus_service_subscribe_handlers((AppFocusHandlers) {
+    .will_focus = prv_will_focus,
+    .did_focus = prv_did_focus,
+  });
+  memstats_sample(MEM_POINT_LOAD);
 
-  // leave a right column for glyphs (36px) and place main text to the left
-  int glyph_w = 36;
-  int glyph_x = bounds.size.w - glyph_w;
-  // Title layer
-  s_title_layer = text_layer_create(GRect(0, 4, bounds.size.w - glyph_w, 34));
-  text_layer_set_text_alignment(s_title_layer, GTextAlignmentCenter);
-  text_layer_set_font(s_title_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD));
-  text_layer_set_text(s_title_layer, "Pebble Says");
-  layer_add_child(window_layer, text_layer_get_layer(s_title_layer));
-
-  // central text block
-  s_text_layer = text_layer_create(GRect(0, 46, bounds.size.w - glyph_w, 44));
-  text_layer_set_text(s_text_layer, "Press Select");
-  text_layer_set_text_alignment(s_text_layer, GTextAlignmentCenter);
-  text_layer_set_font(s_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD));
-  text_layer_set_overflow_mode(s_text_layer, GTextOverflowModeWordWrap);
-  layer_add_child(window_layer, text_layer_get_layer(s_text_layer));
-
-  s_info_layer = text_layer_create(GRect(0, 98, bounds.size.w - glyph_w, 20));
-  text_layer_set_text_alignment(s_info_layer, GTextAlignmentCenter);
-  text_layer_set_font(s_info_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
-  text_layer_set_overflow_mode(s_info_layer, GTextOverflowModeWordWrap);
-  layer_add_child(window_layer, text_layer_get_layer(s_info_layer));
-
-  // distribute glyphs vertically near button positions
-  s_glyph_layers[0] = text_layer_create(GRect(glyph_x, 24, glyph_w, 30)); // Up
-  text_layer_set_text_alignment(s_glyph_layers[0], GTextAlignmentCenter);
-  text_layer_set_font(s_glyph_layers[0], fonts_get_system_font(FONT_KEY_GOTHIC_24));
-  text_layer_set_text(s_glyph_layers[0], "U");
-  layer_add_child(window_layer, text_layer_get_layer(s_glyph_layers[0]));
-
-  s_glyph_layers[1] = text_layer_create(GRect(glyph_x, bounds.size.h/2 - 15, glyph_w, 30)); // Select
-  text_layer_set_text_alignment(s_glyph_layers[1], GTextAlignmentCenter);
-  text_layer_set_font(s_glyph_layers[1], fonts_get_system_font(FONT_KEY_GOTHIC_24));
-  text_layer_set_text(s_glyph_layers[1], "S");
-  layer_add_child(window_layer, text_layer_get_layer(s_glyph_layers[1]));
-
-  s_glyph_layers[2] = text_layer_create(GRect(glyph_x, bounds.size.h - 50, glyph_w, 30)); // Down
-  text_layer_set_text_alignment(s_glyph_layers[2], GTextAlignmentCenter);
-  text_layer_set_font(s_glyph_layers[2], fonts_get_system_font(FONT_KEY_GOTHIC_24));
-  text_layer_set_text(s_glyph_layers[2], "D");
-  layer_add_child(window_layer, text_layer_get_layer(s_glyph_layers[2]));
-
-  // initialize glyph colors in non-highlight state
-  for (int i = 0; i < 3; ++i) {
-    highlight_glyph(i, false);
+  if (s_resume_pending) {
+    // skip the title flow: straight back into the interrupted round
+    s_resume_pending = false;
+    prv_game_starting();
+    render_hold();
+    if (game_resume(&s_resume)) prv_game_started();
+    render_release();
   }
+}
 
+static void prv_save_snapshot(void) {
+  GameSnapshot snapshot;
+  // a replayed run isn't worth resuming, but a stale stored one still goes
+  if (!s_replaying && game_snapshot(&snapshot)) {
+    persist_write_data(PERSIST_KEY_SNAPSHOT, &snapshot, sizeof(snapshot));
+  } else if (s_snapshot_stored) {
+    // the run finished (or never resumed): don't bring it back next launch
+    persist_delete(PERSIST_KEY_SNAPSHOT);
+  }
+}
 
-  // flash layer on top (initially invisible until transition)
-  s_flash_layer = layer_create(bounds);
-  layer_set_update_proc(s_flash_layer, flash_layer_update_proc);
-  layer_add_child(window_layer, s_flash_layer);
-
-  update_info_layer();
-  apply_layout();
+static void prv_window_appear(Window *window) {
+  // whatever covered us may have drawn into the framebuffer
+  render_invalidate();
 }
 
 static void prv_window_unload(Window *window) {
-  if (s_sequence_timer) {
-    app_timer_cancel(s_sequence_timer);
-    s_sequence_timer = NULL;
-  }
-  if (s_feedback_timer) {
-    app_timer_cancel(s_feedback_timer);
-    s_feedback_timer = NULL;
-  }
-  if (s_transition_timer) {
-    app_timer_cancel(s_transition_timer);
-    s_transition_timer = NULL;
-  }
-  if (s_flash_timer) {
-    app_timer_cancel(s_flash_timer);
-    s_flash_timer = NULL;
-  }
-  text_layer_destroy(s_text_layer);
-  text_layer_destroy(s_info_layer);
-  if (s_title_layer) {
-    text_layer_destroy(s_title_layer);
-    s_title_layer = NULL;
-  }
-  for (int i = 0; i < 3; ++i) {
-    if (s_glyph_layers[i]) {
-      text_layer_destroy(s_glyph_layers[i]);
-      s_glyph_layers[i] = NULL;
-    }
-  }
-  if (s_flash_layer) {
-    layer_destroy(s_flash_layer);
-    s_flash_layer = NULL;
+  memstats_sample(MEM_POINT_UNLOAD);
+  memstats_log();
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+  unobstructed_area_service_unsubscribe();
+#endif
+  app_focus_service_unsubscribe();
+  // before the cancel, which clears s_replaying
+  prv_save_snapshot();
+  if (s_replaying) prv_playback_cancel();
+  prv_save_replay();
+  stats_flush();
+  // drops every pending deadline and the backing AppTimer in one go
+  scheduler_cancel_all();
+  playback_deinit();
+  render_deinit();
+}
+
+static void prv_power_changed(PowerProfile profile) {
+  // the battery can report before the window has loaded
+  if (render_get_layer()) update_info_layer();
+}
+
+// Whether a long press means anything right now; while it does, press
+// mode holds the button's short press until release.
+static bool prv_between_games(void) {
+  return !s_replaying && game_is_over(game_get_state());
+}
+
+static bool prv_long_up_armed(void) {
+  // in play it is the profiler, which release builds leave out
+  return prv_between_games() || PROFILER_ENABLED;
+}
+
+// Long-press Up: the power setting between games, the profiler in play.
+static void prv_long_up(ButtonId button) {
+  if (game_is_over(game_get_state())) {
+    power_cycle_setting();
+    update_info_layer();
+    return;
   }
+#if PROFILER_ENABLED
+  profiler_toggle(button);
+#endif
 }
 
 static void prv_init(void) {
-  srand(time(NULL));
+  s_init_ms = prv_now_ms();
+  game_seed(s_init_ms);
+  trace_init(prv_now_ms);
+#if PROFILER_ENABLED
+  profiler_init(prv_now_ms);
+#endif
+#if BENCH_ENABLED
+  bench_init(prv_now_ms);
+#endif
+  memstats_sample(MEM_POINT_INIT);
+  scheduler_init(&s_sched_backend);
+  playback_init(sequence_edge, game_edge_shown, prv_now_ms);
+  haptics_init(prv_now_ms);
+  power_init(prv_power_changed);
+  // one read decides between the title screen and resuming a run
+  s_snapshot_stored = persist_read_data(PERSIST_KEY_SNAPSHOT, &s_resume, sizeof(s_resume)) ==
+                      (int)sizeof(s_resume);
+  // a benchmark always starts from the title screen
+  s_resume_pending = s_snapshot_stored && !BENCH_ENABLED;
+  // initialize game state: show start message until user presses select
+  game_init(&s_platform);
+
   s_window = window_create();
-  window_set_click_config_provider(s_window, prv_click_config_provider);
+  input_init(s_window, prv_button_handler, prv_now_ms);
+#if GAME_TRACE_ENABLED
+  input_set_long_press_handler(BUTTON_ID_SELECT, prv_trace_dump, prv_between_games);
+#endif
+  input_set_long_press_handler(BUTTON_ID_UP, prv_long_up, prv_long_up_armed);
+  input_set_long_press_handler(BUTTON_ID_DOWN, prv_playback_start, prv_between_games);
   window_set_window_handlers(s_window, (WindowHandlers) {
     .load = prv_window_load,
+    .appear = prv_window_appear,
     .unload = prv_window_unload,
   });
   const bool animated = true;
   window_stack_push(s_window, animated);
-
-  // initialize game state
-  s_seq_len = 0;
-  s_round = 0;
-  s_game_over = true; // show start message until user presses select
-  update_info_layer();
 }
 
 static void prv_deinit(void) {
+  power_deinit();
   window_destroy(s_window);
 }
 
 int main(void) {
+  char stack_base = 0;
+  memstats_init(&stack_base);
   prv_init();
 
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "Done initializing, pushed window: %p", s_window);
+  GAME_LOG_DEBUG("Done initializing, pushed window: %p", s_window);
 
   app_event_loop();
   prv_deinit();
-}
\ No newline at end of file
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// Every persistent storage key the app uses, in one place so blobs never
+// collide. Each blob starts with its own version byte; bump it (and handle
+// or drop the old layout) when a blob's format changes.
+
+typedef enum {
+  PERSIST_KEY_STATS = 1,        // StatsBlob
+  PERSIST_KEY_REACTION_HIST,    // StatsHistBlob, reaction times
+  PERSIST_KEY_ROUND_HIST,       // StatsHistBlob, round times
+  PERSIST_KEY_SNAPSHOT,         // GameSnapshot of a run interrupted by exit
+  PERSIST_KEY_REPLAY,           // Replay of the last run, split over the next keys
+  PERSIST_KEY_REPLAY_END = PERSIST_KEY_REPLAY + 3,
+  PERSIST_KEY_POWER,            // int PowerSetting
+} PersistKey;
@@ -0,0 +1,138 @@
+#include "playback.h"
+#include "render.h"
+
+#define PLAYBACK_DEFAULT_FRAME_MS 33  // the animation service targets ~30 fps
+
+static PlaybackEdgeHandler s_on_edge;
+static PlaybackShownHandler s_on_shown;
+static uint32_t (*s_now_ms)(void);
+static Animation *s_animation;
+static bool s_pending;         // an edge is armed
+static uint32_t s_due_ms;      // deadline of the armed edge
+static bool s_staged;          // an edge already ran and waits to be shown
+static uint32_t s_staged_due_ms;
+static bool s_in_edge;         // inside s_on_edge()
+static uint32_t s_edge_now_ms; // what playback_now_ms() reports meanwhile
+static uint32_t s_last_frame_ms;
+static uint32_t s_frame_ms = PLAYBACK_DEFAULT_FRAME_MS;  // measured frame period
+static uint32_t s_frames;      // update calls, each one a wakeup
+
+static inline bool reached(uint32_t now, uint32_t due) {
+  return (int32_t)(now - due) >= 0;
+}
+
+// Commits the staged edge; this frame is the one that shows it.
+static void show_edge(uint32_t now) {
+  s_staged = false;
+  render_release();
+  if (s_on_shown) s_on_shown(now);
+}
+
+static void stop_animation(void) {
+  if (s_animation) {
+    // SDK 3 destroys unscheduled animations; teardown clears the pointer
+    animation_unschedule(s_animation);
+    s_animation = NULL;
+  }
+}
+
+// Runs the armed edge with the renderer held so its changes can be
+// committed on the frame that matches its deadline.
+static void run_edge(uint32_t now) {
+  s_pending = false;
+  s_staged_due_ms = s_due_ms;
+  s_in_edge = true;
+  // early (pipelined) edges are presented at their deadline
+  s_edge_now_ms = reached(now, s_due_ms) ? now : s_due_ms;
+  render_hold();
+  s_on_edge();
+  s_in_edge = false;
+  s_staged = true;
+}
+
+uint32_t playback_now_ms(void) {
+  return s_in_edge ? s_edge_now_ms : s_now_ms();
+}
+
+static void update(Animation *animation, const AnimationProgress progress) {
+  uint32_t now = s_now_ms();
+  s_frames++;
+  if (s_last_frame_ms) {
+    // track the real frame period; smooth out the odd long frame
+    uint32_t frame = now - s_last_frame_ms;
+    if (frame > 0 && frame < 200) s_frame_ms = (s_frame_ms * 3 + frame) / 4;
+  }
+  s_last_frame_ms = now;
+  uint32_t half = s_frame_ms / 2;
+
+  if (s_staged && reached(now + half, s_staged_due_ms)) show_edge(now);
+  if (s_pending && !s_staged) {
+    if (reached(now + half, s_due_ms)) {
+      // late or due this frame: run and show immediately
+      run_edge(now);
+      show_edge(now);
+    } else if (reached(now + s_frame_ms + half, s_due_ms)) {
+      // due next frame: prepare it now, show it then
+      run_edge(now);
+    }
+  }
+  if (!s_pending && !s_staged) {
+    // nothing left to play: stop asking for frames
+    stop_animation();
+  }
+}
+
+static void teardown(Animation *animation) {
+  if (animation == s_animation) s_animation = NULL;
+}
+
+static const AnimationImplementation s_implementation = {
+  .update = update,
+  .teardown = teardown,
+};
+
+static void start_animation(void) {
+  if (s_animation) return;
+  s_animation = animation_create();
+  if (!s_animation) return;
+  animation_set_implementation(s_animation, &s_implementation);
+  animation_set_duration(s_animation, ANIMATION_DURATION_INFINITE);
+  s_last_frame_ms = 0;
+  animation_schedule(s_animation);
+}
+
+void playback_schedule(uint32_t delay_ms) {
+  s_due_ms = playback_now_ms() + delay_ms;
+  s_pending = true;
+  start_animation();
+}
+
+void playback_cancel(void) {
+  s_pending = false;
+  if (s_staged) {
+    s_staged = false;
+    render_release();
+  }
+  if (!s_in_edge) stop_animation();
+}
+
+uint32_t playback_frame_count(void) {
+  return s_frames;
+}
+
+bool playback_is_active(void) {
+  return s_pending || s_staged;
+}
+
+void playback_init(PlaybackEdgeHandler on_edge, PlaybackShownHandler on_shown, uint32_t (*now_ms)(void)) {
+  s_on_edge = on_edge;
+  s_on_shown = on_shown;
+  s_now_ms = now_ms;
+  s_pending = s_staged = s_in_edge = false;
+  s_frame_ms = PLAYBACK_DEFAULT_FRAME_MS;
+}
+
+void playback_deinit(void) {
+  playback_cancel();
+  stop_animation();
+}
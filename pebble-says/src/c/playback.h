@@ -0,0 +1,31 @@
+#pragma once
+
+// Frame-synchronised sequence playback. While the sequence is showing, a
+// custom Animation runs and each show/pause edge fires on the display frame
+// closest to its deadline instead of whenever an AppTimer happens to run.
+// The edge for the next frame is pipelined: it runs one frame early with
+// the renderer held, and its render state is committed on the edge frame.
+// That commit is when the edge reaches the screen, so it is reported to
+// the shown handler with the frame's real time.
+
+#include <pebble.h>
+
+typedef void (*PlaybackEdgeHandler)(void);
+typedef void (*PlaybackShownHandler)(uint32_t shown_ms);
+
+void playback_init(PlaybackEdgeHandler on_edge, PlaybackShownHandler on_shown, uint32_t (*now_ms)(void));
+void playback_deinit(void);
+
+// Arms the next edge delay_ms after the previous one (or after now when
+// nothing is playing). Starts the animation if it isn't running.
+void playback_schedule(uint32_t delay_ms);
+void playback_cancel(void);
+bool playback_is_active(void);
+// Animation frames run so far, for wakeup accounting.
+uint32_t playback_frame_count(void);
+
+// Clock for the code an edge runs. A pipelined edge runs a frame early but
+// is meant for its deadline, so while it runs "now" is that deadline and
+// what it schedules is timed from there; late edges see the real time.
+// This is not a measurement: the shown handler gets the commit time.
+uint32_t playback_now_ms(void);
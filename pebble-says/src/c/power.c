@@ -0,0 +1,110 @@
+#include "power.h"
+#include "game_log.h"
+#include "persist_keys.h"
+
+static const PowerPolicy s_policies[POWER_PROFILE_COUNT] = {
+  [POWER_PROFILE_NORMAL] = {
+    .max_flash_cycles = 7,
+    .flash_tick_ms = 0,
+    .full_screen_flash = true,
+    .haptics = HAPTICS_MODE_FULL,
+  },
+  [POWER_PROFILE_SAVER] = {
+    // 3 ticks of 200 ms still end inside the shortest round transition
+    .max_flash_cycles = 3,
+    .flash_tick_ms = 200,
+    .full_screen_flash = false,
+    .haptics = HAPTICS_MODE_REDUCED,
+  },
+};
+
+static PowerChangeHandler s_on_change;
+static PowerSetting s_setting;
+static PowerProfile s_profile;
+static bool s_battery_low;  // auto's view of the battery, with hysteresis
+static PowerStats s_stats[POWER_PROFILE_COUNT];
+static uint32_t s_last_wakeups;
+static uint32_t s_last_redraws;
+
+static PowerProfile wanted_profile(void) {
+  switch (s_setting) {
+    case POWER_SETTING_SAVER: return POWER_PROFILE_SAVER;
+    case POWER_SETTING_FULL: return POWER_PROFILE_NORMAL;
+    default: return s_battery_low ? POWER_PROFILE_SAVER : POWER_PROFILE_NORMAL;
+  }
+}
+
+static void apply_profile(bool notify) {
+  PowerProfile profile = wanted_profile();
+  if (profile == s_profile && notify) return;
+  s_profile = profile;
+  haptics_set_mode(s_policies[profile].haptics);
+  GAME_LOG_INFO("Power profile %s", power_profile_name(profile));
+  if (notify && s_on_change) s_on_change(profile);
+}
+
+static void battery_handler(BatteryChargeState charge) {
+  bool external = charge.is_charging || charge.is_plugged;
+  if (external || charge.charge_percent >= POWER_OK_PERCENT) {
+    s_battery_low = false;
+  } else if (charge.charge_percent <= POWER_LOW_PERCENT) {
+    s_battery_low = true;
+  }
+  apply_profile(true);
+}
+
+void power_init(PowerChangeHandler on_change) {
+  s_on_change = on_change;
+  s_setting = POWER_SETTING_AUTO;
+  if (persist_exists(PERSIST_KEY_POWER)) {
+    int32_t setting = persist_read_int(PERSIST_KEY_POWER);
+    if (setting >= 0 && setting < POWER_SETTING_COUNT) s_setting = (PowerSetting)setting;
+  }
+  BatteryChargeState charge = battery_state_service_peek();
+  s_battery_low = !charge.is_charging && !charge.is_plugged && charge.charge_percent <= POWER_LOW_PERCENT;
+  apply_profile(false);
+  battery_state_service_subscribe(battery_handler);
+}
+
+void power_deinit(void) {
+  battery_state_service_unsubscribe();
+}
+
+PowerProfile power_get_profile(void) {
+  return s_profile;
+}
+
+const PowerPolicy *power_get_policy(void) {
+  return &s_policies[s_profile];
+}
+
+PowerSetting power_get_setting(void) {
+  return s_setting;
+}
+
+void power_cycle_setting(void) {
+  s_setting = (PowerSetting)((s_setting + 1) % POWER_SETTING_COUNT);
+  persist_write_int(PERSIST_KEY_POWER, s_setting);
+  apply_profile(true);
+}
+
+const char *power_profile_name(PowerProfile profile) {
+  return profile == POWER_PROFILE_SAVER ? "saver" : "normal";
+}
+
+void power_round_end(int round, uint32_t wakeups, uint32_t redraws) {
+  uint32_t round_wakeups = wakeups - s_last_wakeups;
+  uint32_t round_redraws = redraws - s_last_redraws;
+  s_last_wakeups = wakeups;
+  s_last_redraws = redraws;
+  PowerStats *stats = &s_stats[s_profile];
+  stats->rounds++;
+  stats->wakeups += round_wakeups;
+  stats->redraws += round_redraws;
+  GAME_LOG_INFO("Round %d (%s): %lu wakeups, %lu redraws", round, power_profile_name(s_profile),
+                (unsigned long)round_wakeups, (unsigned long)round_redraws);
+}
+
+const PowerStats *power_get_stats(PowerProfile profile) {
+  return &s_stats[profile];
+}
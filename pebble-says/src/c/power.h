@@ -0,0 +1,61 @@
+#pragma once
+
+// Power profile for the watch side of the game. The battery service picks
+// it automatically (saver when the battery runs low and isn't charging) or
+// a persisted manual setting pins it. The saver profile caps celebration
+// flash cycles and slows their ticks, keeps milestone flashes to the glyph
+// column instead of the whole screen, and switches haptics to the reduced
+// patterns. Game timing is untouched, so replays play back the same either
+// way. Timer wakeups and redraws are counted per round in each profile.
+
+#include <pebble.h>
+
+#include "haptics.h"
+
+#define POWER_LOW_PERCENT 20  // auto: saver at or below this while unplugged
+#define POWER_OK_PERCENT 30   // ...and back to normal from this
+
+typedef enum {
+  POWER_PROFILE_NORMAL = 0,
+  POWER_PROFILE_SAVER,
+  POWER_PROFILE_COUNT
+} PowerProfile;
+
+typedef enum {
+  POWER_SETTING_AUTO = 0,  // follow the battery
+  POWER_SETTING_SAVER,
+  POWER_SETTING_FULL,
+  POWER_SETTING_COUNT
+} PowerSetting;
+
+typedef struct {
+  uint8_t max_flash_cycles;  // celebrations are capped at this; odd, so it ends unflashed
+  uint16_t flash_tick_ms;    // 0 keeps the platform's own interval
+  bool full_screen_flash;    // milestones may flash the whole screen
+  HapticsMode haptics;
+} PowerPolicy;
+
+typedef struct {
+  uint32_t rounds;
+  uint32_t wakeups;  // scheduler timer wakeups and playback frames
+  uint32_t redraws;  // render update procs
+} PowerStats;
+
+typedef void (*PowerChangeHandler)(PowerProfile profile);
+
+// Reads the persisted setting and subscribes to the battery service.
+// on_change runs whenever the profile in effect changes afterwards.
+void power_init(PowerChangeHandler on_change);
+void power_deinit(void);
+
+PowerProfile power_get_profile(void);
+const PowerPolicy *power_get_policy(void);
+PowerSetting power_get_setting(void);
+// Auto -> saver -> full -> auto; persisted.
+void power_cycle_setting(void);
+const char *power_profile_name(PowerProfile profile);
+
+// Closes the accounting for a round. wakeups and redraws are running
+// totals; the round is charged the difference to the previous call.
+void power_round_end(int round, uint32_t wakeups, uint32_t redraws);
+const PowerStats *power_get_stats(PowerProfile profile);
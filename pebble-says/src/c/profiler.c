@@ -0,0 +1,83 @@
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+
+#include "benchmark.h"
+#include "game_core.h"
+#include "render.h"
+#include "scheduler.h"
+
+#define PROFILER_BOX_H 48  // three lines of Gothic 14
+
+static uint32_t (*s_now_ms)(void);
+static ProfileTiming s_timings[PROFILE_SLOT_COUNT];
+static bool s_visible;
+static uint32_t s_refreshed_ms;
+static GFont s_font;
+
+uint32_t profiler_now_ms(void) {
+  return s_now_ms ? s_now_ms() : 0;
+}
+
+void profiler_record(ProfileSlot slot, uint32_t start_ms) {
+  if (!s_now_ms || slot < 0 || slot >= PROFILE_SLOT_COUNT) return;
+  uint32_t now = s_now_ms();
+  uint32_t elapsed = now - start_ms;
+  ProfileTiming *timing = &s_timings[slot];
+  timing->count++;
+  timing->last_ms = elapsed > UINT16_MAX ? UINT16_MAX : (uint16_t)elapsed;
+  if (timing->last_ms > timing->max_ms) timing->max_ms = timing->last_ms;
+#if BENCH_ENABLED
+  bench_record(slot, elapsed);
+#endif
+  // piggyback on activity that happens anyway: an idle app stays idle
+  if (s_visible && slot != PROFILE_DRAW && now - s_refreshed_ms >= PROFILER_REFRESH_MS) {
+    s_refreshed_ms = now;
+    render_refresh_overlay();
+  }
+}
+
+const ProfileTiming *profiler_get(ProfileSlot slot) {
+  return &s_timings[slot];
+}
+
+static void draw_overlay(GContext *ctx, GRect bounds) {
+  // sized for the format's worst case (148 bytes with the NUL), so nothing is cut off
+  static char text[148];
+  const GameTiming *drift = game_get_timing();
+  const GameInputStats *input = game_get_input_stats();
+  const ProfileTiming *draw = &s_timings[PROFILE_DRAW];
+  const ProfileTiming *timer = &s_timings[PROFILE_TIMER];
+  const ProfileTiming *press = &s_timings[PROFILE_INPUT];
+  snprintf(text, sizeof(text), "draw %u/%u tmr %u/%u in %u/%u\nlate %ld/%ld ms sched %d\nheap %lu q%lu d%lu",
+           draw->last_ms, draw->max_ms, timer->last_ms, timer->max_ms, press->last_ms, press->max_ms,
+           (long)drift->last_error_ms, (long)drift->max_error_ms, scheduler_pending_count(),
+           (unsigned long)heap_bytes_free(), (unsigned long)input->queued, (unsigned long)input->dropped);
+#ifdef PBL_ROUND
+  GRect box = GRect(bounds.size.w / 6, 14, bounds.size.w * 2 / 3, PROFILER_BOX_H);
+#else
+  GRect box = GRect(0, 0, bounds.size.w, PROFILER_BOX_H);
+#endif
+  graphics_context_set_fill_color(ctx, GColorBlack);
+  graphics_fill_rect(ctx, box, 0, GCornerNone);
+  graphics_context_set_text_color(ctx, GColorWhite);
+  graphics_draw_text(ctx, text, s_font, box, GTextOverflowModeTrailingEllipsis, GTextAlignmentCenter, NULL);
+}
+
+void profiler_toggle(ButtonId button) {
+  s_visible = !s_visible;
+  if (s_visible) {
+    // maxima since the box was opened
+    for (int i = 0; i < PROFILE_SLOT_COUNT; ++i) s_timings[i].max_ms = 0;
+    if (!s_font) s_font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  }
+  render_set_overlay(s_visible ? draw_overlay : NULL);
+}
+
+void profiler_init(uint32_t (*now_ms)(void)) {
+  s_now_ms = now_ms;
+  s_visible = false;
+  for (int i = 0; i < PROFILE_SLOT_COUNT; ++i) s_timings[i] = (ProfileTiming) { 0 };
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+// Debug profiler: time_ms() samples around the update proc, the scheduler
+// wakeup, button handling and playback edges, shown live in a small box
+// drawn over the top of the screen with timer lateness, free heap, pending
+// deadlines and type-ahead counts. Long-press Up in play toggles it.
+// Release builds compile every sample and the overlay out.
+
+#include <pebble.h>
+
+#ifndef PROFILER_ENABLED
+#ifdef PEBBLE_SAYS_RELEASE
+#define PROFILER_ENABLED 0
+#else
+#define PROFILER_ENABLED 1
+#endif
+#endif
+
+#define PROFILER_REFRESH_MS 250  // redraw the box at most this often
+
+typedef enum {
+  PROFILE_DRAW = 0,  // render update proc
+  PROFILE_TIMER,     // one scheduler wakeup, every due callback included
+  PROFILE_INPUT,     // button handler
+  PROFILE_EDGE,      // playback show/pause edge
+  PROFILE_SLOT_COUNT
+} ProfileSlot;
+
+typedef struct {
+  uint32_t count;
+  uint16_t last_ms;
+  uint16_t max_ms;
+} ProfileTiming;
+
+#if PROFILER_ENABLED
+#define PROFILE_BEGIN(var) uint32_t var = profiler_now_ms()
+#define PROFILE_END(slot, var) profiler_record((slot), (var))
+
+void profiler_init(uint32_t (*now_ms)(void));
+uint32_t profiler_now_ms(void);
+void profiler_record(ProfileSlot slot, uint32_t start_ms);
+void profiler_toggle(ButtonId button);
+const ProfileTiming *profiler_get(ProfileSlot slot);
+#else
+#define PROFILE_BEGIN(var) ((void)0)
+#define PROFILE_END(slot, var) ((void)0)
+#endif
@@ -0,0 +1,455 @@
+#include "render.h"
+#include "profiler.h"
+#include "render_round.h"
+
+#include <string.h>
+
+#define RENDER_GLYPHS 3
+#define RENDER_REGIONS (3 + RENDER_GLYPHS)  // region i is bit i of the dirty mask
+#define RENDER_MESSAGE_LEN 24
+#define RENDER_INFO_LEN 48
+
+typedef struct {
+  const char *title;
+  char message[RENDER_MESSAGE_LEN];
+  char info[RENDER_INFO_LEN];
+  bool info_visible;
+  bool glyphs_visible;
+  uint8_t glyph_on;  // bit i set = glyph i highlighted
+  GRect title_frame;
+  GRect message_frame;
+  GRect info_frame;
+  GRect glyph_frames[RENDER_GLYPHS];
+} RenderState;
+
+typedef struct {
+  FlashFxMode mode;
+  GRect region;
+} RenderFlash;
+
+// Colours per platform, picked at compile time so drawing a glyph is one
+// lookup.
+typedef struct {
+  GColor8 fill;
+  GColor8 ink;
+} RenderStyle;
+
+#define RENDER_STYLE(fill, ink) { { .argb = (fill) }, { .argb = (ink) } }
+
+#ifdef PBL_COLOR
+static const RenderStyle s_glyph_styles[2][RENDER_GLYPHS] = {
+  {  // off: coloured letter on white
+    RENDER_STYLE(GColorWhiteARGB8, GColorRedARGB8),
+    RENDER_STYLE(GColorWhiteARGB8, GColorBlueARGB8),
+    RENDER_STYLE(GColorWhiteARGB8, GColorIslamicGreenARGB8),
+  },
+  {  // on: white letter on its colour
+    RENDER_STYLE(GColorRedARGB8, GColorWhiteARGB8),
+    RENDER_STYLE(GColorBlueARGB8, GColorWhiteARGB8),
+    RENDER_STYLE(GColorIslamicGreenARGB8, GColorWhiteARGB8),
+  },
+};
+#else
+static const RenderStyle s_glyph_styles[2][RENDER_GLYPHS] = {
+  {
+    RENDER_STYLE(GColorWhiteARGB8, GColorBlackARGB8),
+    RENDER_STYLE(GColorWhiteARGB8, GColorBlackARGB8),
+    RENDER_STYLE(GColorWhiteARGB8, GColorBlackARGB8),
+  },
+  {
+    RENDER_STYLE(GColorBlackARGB8, GColorWhiteARGB8),
+    RENDER_STYLE(GColorBlackARGB8, GColorWhiteARGB8),
+    RENDER_STYLE(GColorBlackARGB8, GColorWhiteARGB8),
+  },
+};
+#endif
+
+static Layer *s_layer;
+static RenderState s_state;  // committed: what the update proc draws
+static RenderState s_next;   // what callers have asked for since the last commit
+static int s_hold_depth;     // > 0 while changes are being staged
+static uint8_t s_dirty;      // RenderRegion bits waiting for the next update proc
+static RenderStats s_stats;
+static RenderFlash s_flash;        // effect wanted on the next frame
+static RenderFlash s_flash_baked;  // effect currently baked into the framebuffer
+static bool s_flash_changed;
+static GFont s_title_font;
+static GFont s_message_font;
+static GFont s_info_font;
+static GFont s_glyph_font;
+
+static GRect s_vacated[RENDER_REGIONS];  // per region: where it was painted before it moved
+static uint8_t s_vacated_regions;         // regions with a s_vacated entry
+static void (*s_first_frame_handler)(void);  // cleared once it has run
+static void (*s_next_frame_handler)(void);   // likewise
+static RenderOverlayProc s_overlay;
+static bool s_overlay_refresh;  // the next frame only has to repaint the overlay
+
+static const char *const s_glyph_letters[RENDER_GLYPHS] = { "U", "S", "D" };
+
+static void mark(uint8_t regions) {
+  if (!s_layer || !regions) return;
+  s_dirty |= regions;
+  layer_mark_dirty(s_layer);
+}
+
+static bool rect_equal(GRect a, GRect b) {
+  return a.origin.x == b.origin.x && a.origin.y == b.origin.y &&
+         a.size.w == b.size.w && a.size.h == b.size.h;
+}
+
+static void draw_text(GContext *ctx, const char *text, GFont font, GRect frame) {
+  if (!text || !text[0]) return;
+  graphics_draw_text(ctx, text, font, frame, GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+}
+
+static void draw_glyph(GContext *ctx, int idx) {
+  GRect frame = s_state.glyph_frames[idx];
+  bool on = s_state.glyph_on & (1 << idx);
+  const RenderStyle *style = &s_glyph_styles[on][idx];
+#ifdef PBL_ROUND
+  // the segment is repainted whole either way: it is the glyph's own region
+  render_round_fill_segment(ctx, idx, style->fill);
+#else
+  if (on) {
+    graphics_context_set_fill_color(ctx, style->fill);
+    graphics_fill_rect(ctx, frame, 0, GCornerNone);
+  }
+#endif
+  graphics_context_set_text_color(ctx, style->ink);
+  draw_text(ctx, s_glyph_letters[idx], s_glyph_font, frame);
+}
+
+static void clear_region(GContext *ctx, GRect frame) {
+  graphics_context_set_fill_color(ctx, GColorWhite);
+  graphics_fill_rect(ctx, frame, 0, GCornerNone);
+}
+
+static bool rects_overlap(GRect a, GRect b) {
+  return a.origin.x < b.origin.x + b.size.w && b.origin.x < a.origin.x + a.size.w &&
+         a.origin.y < b.origin.y + b.size.h && b.origin.y < a.origin.y + a.size.h;
+}
+
+// Pixels a glyph paints: its segment on round screens, its frame otherwise.
+static GRect glyph_bounds(int idx) {
+#ifdef PBL_ROUND
+  return render_round_segment_bounds(idx);
+#else
+  return s_state.glyph_frames[idx];
+#endif
+}
+
+// Regions whose painted area overlaps rect.
+static uint8_t regions_under(GRect rect) {
+  uint8_t regions = 0;
+  if (rects_overlap(rect, s_state.title_frame)) regions |= RENDER_REGION_TITLE;
+  if (rects_overlap(rect, s_state.message_frame)) regions |= RENDER_REGION_MESSAGE;
+  if (rects_overlap(rect, s_state.info_frame)) regions |= RENDER_REGION_INFO;
+  for (int i = 0; i < RENDER_GLYPHS; ++i) {
+    if (rects_overlap(rect, glyph_bounds(i))) regions |= (uint8_t)(RENDER_REGION_GLYPH_0 << i);
+  }
+  return regions;
+}
+
+// Clearing a text box can cut into a glyph that shares its rows (the ring
+// on round screens); those glyphs are repainted after it.
+static uint8_t glyphs_under(uint8_t dirty) {
+  uint8_t glyphs = 0;
+  for (int i = 0; i < RENDER_GLYPHS; ++i) {
+    GRect g = glyph_bounds(i);
+    if (((dirty & RENDER_REGION_TITLE) && rects_overlap(g, s_state.title_frame)) ||
+        ((dirty & RENDER_REGION_MESSAGE) && rects_overlap(g, s_state.message_frame)) ||
+        ((dirty & RENDER_REGION_INFO) && rects_overlap(g, s_state.info_frame))) {
+      glyphs |= (uint8_t)(RENDER_REGION_GLYPH_0 << i);
+    }
+  }
+  return glyphs;
+}
+
+static void update_proc(Layer *layer, GContext *ctx) {
+  // The window background is clear, so the framebuffer keeps the last frame
+  // and only dirty regions need repainting. A redraw we didn't request (an
+  // overlay went away, another layer was dirtied) repaints everything.
+  s_stats.frames++;
+  if (!s_dirty && !s_flash_changed && s_overlay_refresh && s_overlay) {
+    // the overlay repaints its whole box; nothing under it changed
+    s_overlay_refresh = false;
+    s_overlay(ctx, layer_get_bounds(layer));
+    return;
+  }
+  s_overlay_refresh = false;
+  PROFILE_BEGIN(draw_start);
+  uint8_t dirty = s_dirty;
+  bool flash_only = !dirty && s_flash_changed;
+  if (!dirty && !flash_only) dirty = RENDER_REGION_ALL;
+  s_dirty = 0;
+  s_flash_changed = false;
+
+  if (s_flash_baked.mode != FLASH_FX_NONE) {
+    if (flash_only && s_flash_baked.mode == FLASH_FX_INVERT) {
+      // undo the previous invert in place instead of redrawing under it
+      flash_fx_apply(ctx, s_flash_baked.region, FLASH_FX_INVERT);
+    } else {
+      dirty = RENDER_REGION_ALL;
+    }
+    s_flash_baked.mode = FLASH_FX_NONE;
+  }
+
+  if (dirty != RENDER_REGION_ALL) {
+    // frames that moved leave their old pixels behind; each is cleared on
+    // its own so whatever sits between them and didn't move is left alone
+    for (int i = 0; i < RENDER_REGIONS; ++i) {
+      if (!(s_vacated_regions & (1 << i))) continue;
+      clear_region(ctx, s_vacated[i]);
+      dirty |= regions_under(s_vacated[i]);
+    }
+  }
+  s_vacated_regions = 0;
+  if (dirty == RENDER_REGION_ALL) {
+    clear_region(ctx, layer_get_bounds(layer));
+  } else {
+    dirty |= glyphs_under(dirty);
+  }
+
+  graphics_context_set_text_color(ctx, GColorBlack);
+  if (dirty & RENDER_REGION_TITLE) {
+    if (dirty != RENDER_REGION_ALL) clear_region(ctx, s_state.title_frame);
+    draw_text(ctx, s_state.title, s_title_font, s_state.title_frame);
+  }
+  if (dirty & RENDER_REGION_MESSAGE) {
+    if (dirty != RENDER_REGION_ALL) clear_region(ctx, s_state.message_frame);
+    draw_text(ctx, s_state.message, s_message_font, s_state.message_frame);
+  }
+  if (dirty & RENDER_REGION_INFO) {
+    if (dirty != RENDER_REGION_ALL) clear_region(ctx, s_state.info_frame);
+    if (s_state.info_visible) draw_text(ctx, s_state.info, s_info_font, s_state.info_frame);
+  }
+  for (int i = 0; i < RENDER_GLYPHS; ++i) {
+    if (dirty & (RENDER_REGION_GLYPH_0 << i)) {
+#ifdef PBL_ROUND
+      // draw_glyph repaints the whole segment; a hidden one is cleared the same way
+      if (!s_state.glyphs_visible) render_round_fill_segment(ctx, i, GColorWhite);
+#else
+      if (dirty != RENDER_REGION_ALL) clear_region(ctx, s_state.glyph_frames[i]);
+#endif
+      if (s_state.glyphs_visible) draw_glyph(ctx, i);
+    }
+  }
+  if (dirty != RENDER_REGION_ALL) s_stats.partial_frames++;
+
+  if (s_flash.mode != FLASH_FX_NONE) {
+    flash_fx_apply(ctx, s_flash.region, s_flash.mode);
+    s_flash_baked = s_flash;
+  }
+  PROFILE_END(PROFILE_DRAW, draw_start);
+  if (s_overlay) s_overlay(ctx, layer_get_bounds(layer));
+
+  if (s_first_frame_handler) {
+    void (*handler)(void) = s_first_frame_handler;
+    s_first_frame_handler = NULL;
+    handler();
+  }
+  if (s_next_frame_handler) {
+    void (*handler)(void) = s_next_frame_handler;
+    s_next_frame_handler = NULL;
+    handler();
+  }
+}
+
+// Diffs the staged state against what is on screen and dirties only the
+// regions that really differ, so a change undone before commit costs nothing.
+static uint8_t moved(GRect from, GRect to, int idx) {
+  if (rect_equal(from, to)) return 0;
+  uint8_t region = (uint8_t)(1 << idx);
+  // moved twice between frames: only the first position was ever painted
+  if (!(s_vacated_regions & region) && from.size.w > 0 && from.size.h > 0) {
+    s_vacated[idx] = from;
+    s_vacated_regions |= region;
+  }
+  return region;
+}
+
+static void commit(void) {
+  // a moved frame repaints just its region; where it was is cleared (and
+  // whatever overlaps that repainted) by the next frame
+  uint8_t regions = 0;
+  regions |= moved(s_state.title_frame, s_next.title_frame, 0);
+  regions |= moved(s_state.message_frame, s_next.message_frame, 1);
+  regions |= moved(s_state.info_frame, s_next.info_frame, 2);
+  for (int i = 0; i < RENDER_GLYPHS; ++i) {
+    regions |= moved(s_state.glyph_frames[i], s_next.glyph_frames[i], 3 + i);
+  }
+  if (s_next.title != s_state.title) regions |= RENDER_REGION_TITLE;
+  if (strcmp(s_next.message, s_state.message) != 0) regions |= RENDER_REGION_MESSAGE;
+  if (s_next.info_visible != s_state.info_visible ||
+      (s_next.info_visible && strcmp(s_next.info, s_state.info) != 0)) {
+    regions |= RENDER_REGION_INFO;
+  }
+  uint8_t glyphs = s_next.glyphs_visible != s_state.glyphs_visible ? 0x7
+                                                                    : (s_next.glyph_on ^ s_state.glyph_on) & 0x7;
+  regions |= (uint8_t)(glyphs * RENDER_REGION_GLYPH_0);
+  s_state = s_next;
+  if (regions) s_stats.commits++;
+  else s_stats.noop_commits++;
+  mark(regions);
+}
+
+static void changed(void) {
+  if (s_hold_depth == 0) commit();
+}
+
+void render_hold(void) {
+  s_hold_depth++;
+}
+
+void render_release(void) {
+  if (s_hold_depth > 0 && --s_hold_depth == 0) commit();
+}
+
+void render_set_title(const char *title) {
+  if (s_next.title == title) return;
+  s_next.title = title;
+  changed();
+}
+
+void render_set_message(const char *msg) {
+  if (!msg) msg = "";
+  // copy: callers reuse static buffers, so pointer equality means nothing
+  if (strncmp(s_next.message, msg, sizeof(s_next.message)) == 0) return;
+  strncpy(s_next.message, msg, sizeof(s_next.message) - 1);
+  changed();
+}
+
+void render_set_info(const char *info) {
+  if (!info) info = "";
+  if (strncmp(s_next.info, info, sizeof(s_next.info)) == 0) return;
+  strncpy(s_next.info, info, sizeof(s_next.info) - 1);
+  changed();
+}
+
+void render_set_info_visible(bool visible) {
+  if (s_next.info_visible == visible) return;
+  s_next.info_visible = visible;
+  changed();
+}
+
+void render_set_glyphs_visible(bool visible) {
+  if (s_next.glyphs_visible == visible) return;
+  // the glyph font is only needed once the column is first shown
+  if (visible && !s_glyph_font) s_glyph_font = fonts_get_system_font(FONT_KEY_GOTHIC_24);
+#ifdef PBL_ROUND
+  // segment spans are rasterised when the ring is first needed, not at startup
+  static bool s_ring_built;
+  if (visible && !s_ring_built && s_layer) {
+    render_round_init(layer_get_bounds(s_layer));
+    s_ring_built = true;
+  }
+#endif
+  s_next.glyphs_visible = visible;
+  changed();
+}
+
+void render_set_first_frame_handler(void (*handler)(void)) {
+  s_first_frame_handler = handler;
+}
+
+void render_set_next_frame_handler(void (*handler)(void)) {
+  s_next_frame_handler = handler;
+}
+
+void render_set_glyph(int idx, bool on) {
+  if (idx < 0 || idx >= RENDER_GLYPHS) return;
+  uint8_t bit = 1 << idx;
+  if (((s_next.glyph_on & bit) != 0) == on) return;
+  s_next.glyph_on = on ? (s_next.glyph_on | bit) : (s_next.glyph_on & ~bit);
+  changed();
+}
+
+void render_set_frames(GRect title, GRect message, GRect info) {
+  if (rect_equal(title, s_next.title_frame) && rect_equal(message, s_next.message_frame) &&
+      rect_equal(info, s_next.info_frame)) {
+    return;
+  }
+  s_next.title_frame = title;
+  s_next.message_frame = message;
+  s_next.info_frame = info;
+  changed();
+}
+
+void render_set_glyph_frame(int idx, GRect frame) {
+  if (idx < 0 || idx >= RENDER_GLYPHS || rect_equal(frame, s_next.glyph_frames[idx])) return;
+  s_next.glyph_frames[idx] = frame;
+  changed();
+}
+
+void render_invalidate(void) {
+  mark(RENDER_REGION_ALL);
+}
+
+void render_set_overlay(RenderOverlayProc proc) {
+  if (proc == s_overlay) return;
+  // taking it away leaves its pixels behind
+  if (!proc) mark(RENDER_REGION_ALL);
+  s_overlay = proc;
+  if (proc) render_refresh_overlay();
+}
+
+void render_refresh_overlay(void) {
+  if (!s_overlay || !s_layer) return;
+  s_overlay_refresh = true;
+  layer_mark_dirty(s_layer);
+}
+
+void render_set_flash(FlashFxMode mode, GRect region) {
+  if (mode == s_flash.mode && (mode == FLASH_FX_NONE || rect_equal(region, s_flash.region))) return;
+  s_flash = (RenderFlash) { .mode = mode, .region = region };
+  s_flash_changed = true;
+  if (s_layer) layer_mark_dirty(s_layer);
+}
+
+GRect render_get_glyph_column(void) {
+#ifdef PBL_ROUND
+  return render_round_ring_bounds();
+#else
+  GRect top = s_state.glyph_frames[0];
+  GRect bounds = s_layer ? layer_get_bounds(s_layer) : GRectZero;
+  return GRect(top.origin.x, 0, top.size.w, bounds.size.h);
+#endif
+}
+
+const RenderStats *render_get_stats(void) {
+  return &s_stats;
+}
+
+void render_reset_stats(void) {
+  s_stats = (RenderStats) { 0 };
+}
+
+Layer *render_get_layer(void) {
+  return s_layer;
+}
+
+void render_init(Layer *parent, GRect bounds) {
+  memset(&s_state, 0, sizeof(s_state));
+  s_state.info_visible = true;
+  s_state.glyphs_visible = false;  // shown by the first round, which also loads the font
+  s_next = s_state;
+  s_hold_depth = 0;
+  s_flash = s_flash_baked = (RenderFlash) { .mode = FLASH_FX_NONE };
+  s_flash_changed = false;
+  s_title_font = fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD);
+  s_message_font = fonts_get_system_font(FONT_KEY_GOTHIC_28_BOLD);
+  s_info_font = fonts_get_system_font(FONT_KEY_GOTHIC_18);
+  s_glyph_font = NULL;
+  s_layer = layer_create(bounds);
+  layer_set_update_proc(s_layer, update_proc);
+  layer_add_child(parent, s_layer);
+  s_dirty = RENDER_REGION_ALL;
+}
+
+void render_deinit(void) {
+  if (s_layer) {
+    layer_destroy(s_layer);
+    s_layer = NULL;
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// Single-layer renderer for the game screen. The title, command message,
+// round info and U/S/D glyph column are drawn by one update proc from a
+// compact RenderState instead of seven TextLayers. Setters ignore no-op
+// changes and only redraw the regions that actually changed.
+
+#include <pebble.h>
+
+#include "flash_fx.h"
+
+typedef enum {
+  RENDER_REGION_TITLE   = 1 << 0,
+  RENDER_REGION_MESSAGE = 1 << 1,
+  RENDER_REGION_INFO    = 1 << 2,
+  RENDER_REGION_GLYPH_0 = 1 << 3,  // glyph i is RENDER_REGION_GLYPH_0 << i
+  RENDER_REGION_ALL     = (1 << 6) - 1
+} RenderRegion;
+
+typedef struct {
+  uint32_t commits;        // commits that changed something on screen
+  uint32_t noop_commits;   // commits whose changes cancelled out or matched the screen
+  uint32_t frames;         // update proc runs
+  uint32_t partial_frames; // frames that repainted only some regions
+} RenderStats;
+
+void render_init(Layer *parent, GRect bounds);
+void render_deinit(void);
+Layer *render_get_layer(void);
+
+void render_set_title(const char *title);
+void render_set_message(const char *msg);
+void render_set_info(const char *info);
+void render_set_info_visible(bool visible);
+// The glyph column starts hidden; showing it the first time loads its font.
+void render_set_glyphs_visible(bool visible);
+void render_set_glyph(int idx, bool on);
+void render_set_frames(GRect title, GRect message, GRect info);
+void render_set_glyph_frame(int idx, GRect frame);
+
+// Staging: between hold and the matching release, setters only record the
+// wanted state; release commits it in one go, dirtying just the regions
+// that differ from what is on screen. Holds nest.
+void render_hold(void);
+void render_release(void);
+
+// Forces a full repaint, e.g. after an overlay painted over the screen.
+void render_invalidate(void);
+
+const RenderStats *render_get_stats(void);
+void render_reset_stats(void);
+
+// Flash effect applied to the framebuffer after drawing. Switching an
+// invert flash off just inverts again; nothing underneath is redrawn.
+void render_set_flash(FlashFxMode mode, GRect region);
+GRect render_get_glyph_column(void);
+
+// Debug overlay painted over everything (the flash included) at the end of
+// every frame while set. Refreshing it alone skips the rest of the frame;
+// clearing it repaints what it covered.
+typedef void (*RenderOverlayProc)(GContext *ctx, GRect bounds);
+void render_set_overlay(RenderOverlayProc proc);
+void render_refresh_overlay(void);
+
+// Runs once, at the end of the next frame drawn (for time-to-first-frame).
+// Don't touch render state from it; defer that to a timer.
+void render_set_first_frame_handler(void (*handler)(void));
+// One-shot hook for measuring a change: runs at the end of the next frame
+// drawn after it is set, after the first-frame handler. Setting it again
+// before that frame replaces it. Same rules as the first-frame handler.
+void render_set_next_frame_handler(void (*handler)(void));
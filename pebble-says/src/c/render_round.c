@@ -0,0 +1,103 @@
+#include "render_round.h"
+
+#ifdef PBL_ROUND
+
+#include "layout.h"
+
+typedef struct {
+  int16_t y0;
+  uint8_t rows;
+  uint8_t x0[RENDER_ROUND_MAX_ROWS];  // inclusive; x0 > x1 marks an empty row
+  uint8_t x1[RENDER_ROUND_MAX_ROWS];
+  GRect bounds;
+} ArcSpans;
+
+static ArcSpans s_arcs[RENDER_ROUND_SEGMENTS];
+
+static const int16_t s_arc_centre_deg[RENDER_ROUND_SEGMENTS] = {
+  LAYOUT_ARC_UP_DEG, LAYOUT_ARC_SELECT_DEG, LAYOUT_ARC_DOWN_DEG
+};
+
+// Direction of an angle measured clockwise from 12 o'clock, y pointing down.
+static GPoint arc_direction(int deg) {
+  int32_t angle = DEG_TO_TRIGANGLE(deg);
+  return GPoint((int16_t)(sin_lookup(angle) >> 4), (int16_t)(-cos_lookup(angle) >> 4));
+}
+
+// a -> b turns clockwise (or is collinear)
+static bool clockwise(GPoint a, int32_t bx, int32_t by) {
+  return (int32_t)a.x * by - (int32_t)a.y * bx >= 0;
+}
+
+static void build_segment(ArcSpans *arc, GRect bounds, int centre_deg) {
+  const int cx = bounds.size.w / 2;
+  const int cy = bounds.size.h / 2;
+  const int32_t r_out = (bounds.size.w < bounds.size.h ? bounds.size.w : bounds.size.h) / 2;
+  const int32_t r_in = r_out - LAYOUT_RING_W;
+  GPoint from = arc_direction(centre_deg - LAYOUT_ARC_HALF_DEG);
+  GPoint to = arc_direction(centre_deg + LAYOUT_ARC_HALF_DEG);
+
+  arc->rows = 0;
+  int16_t first = -1;
+  int16_t min_x = INT16_MAX, max_x = -1;
+  for (int y = 0; y < bounds.size.h; ++y) {
+    int lo = INT16_MAX, hi = -1;
+    // every segment lies right of the centre, beside the buttons
+    for (int x = cx; x < bounds.size.w; ++x) {
+      // pixel centres, in half pixels to stay on integers
+      int32_t dx = 2 * (x - cx) + 1;
+      int32_t dy = 2 * (y - cy) + 1;
+      int32_t d2 = dx * dx + dy * dy;
+      if (d2 < 4 * r_in * r_in || d2 > 4 * r_out * r_out) continue;
+      if (!clockwise(from, dx, dy) || clockwise(to, dx, dy)) continue;
+      if (x < lo) lo = x;
+      hi = x;
+    }
+    if (hi < 0) {
+      if (first >= 0) break;  // past the segment
+      continue;
+    }
+    if (first < 0) first = (int16_t)y;
+    int row = y - first;
+    if (row >= RENDER_ROUND_MAX_ROWS) break;
+    arc->x0[row] = (uint8_t)lo;
+    arc->x1[row] = (uint8_t)hi;
+    arc->rows = (uint8_t)(row + 1);
+    if (lo < min_x) min_x = (int16_t)lo;
+    if (hi > max_x) max_x = (int16_t)hi;
+  }
+  arc->y0 = first < 0 ? 0 : first;
+  arc->bounds = arc->rows ? GRect(min_x, arc->y0, max_x - min_x + 1, arc->rows) : GRectZero;
+}
+
+void render_round_init(GRect bounds) {
+  for (int i = 0; i < RENDER_ROUND_SEGMENTS; ++i) {
+    build_segment(&s_arcs[i], bounds, s_arc_centre_deg[i]);
+  }
+}
+
+void render_round_fill_segment(GContext *ctx, int idx, GColor color) {
+  if (idx < 0 || idx >= RENDER_ROUND_SEGMENTS) return;
+  const ArcSpans *arc = &s_arcs[idx];
+  graphics_context_set_fill_color(ctx, color);
+  for (int row = 0; row < arc->rows; ++row) {
+    if (arc->x0[row] > arc->x1[row]) continue;
+    graphics_fill_rect(ctx, GRect(arc->x0[row], arc->y0 + row, arc->x1[row] - arc->x0[row] + 1, 1),
+                       0, GCornerNone);
+  }
+}
+
+GRect render_round_segment_bounds(int idx) {
+  if (idx < 0 || idx >= RENDER_ROUND_SEGMENTS) return GRectZero;
+  return s_arcs[idx].bounds;
+}
+
+GRect render_round_ring_bounds(void) {
+  GRect top = s_arcs[0].bounds;
+  GRect bottom = s_arcs[RENDER_ROUND_SEGMENTS - 1].bounds;
+  int16_t x = top.origin.x < bottom.origin.x ? top.origin.x : bottom.origin.x;
+  int16_t right = s_arcs[1].bounds.origin.x + s_arcs[1].bounds.size.w;
+  return GRect(x, top.origin.y, right - x, bottom.origin.y + bottom.size.h - top.origin.y);
+}
+
+#endif
@@ -0,0 +1,22 @@
+#pragma once
+
+// Glyph ring for round displays: each glyph is a radial segment of a ring
+// just inside the bezel, next to its button (angles in layout.h). Every
+// segment is rasterised once, at init, into per-row spans, so highlighting
+// a glyph fills and repaints just that segment's pixels.
+
+#include <pebble.h>
+
+#ifdef PBL_ROUND
+
+#define RENDER_ROUND_SEGMENTS 3
+#define RENDER_ROUND_MAX_ROWS 96  // rows a 40 degree segment can cover on 180x180
+
+void render_round_init(GRect bounds);
+void render_round_fill_segment(GContext *ctx, int idx, GColor color);
+// bounding box of a segment's spans
+GRect render_round_segment_bounds(int idx);
+// bounding box of all segments, the round counterpart of the glyph column
+GRect render_round_ring_bounds(void);
+
+#endif
@@ -0,0 +1,118 @@
+#include "replay.h"
+
+#include <stddef.h>
+
+static Replay s_replay;
+static bool s_recording_enabled = true;
+static bool s_recording;  // a run is in progress and the arena has room
+static uint32_t s_last_ms;
+
+static bool put_varint(uint32_t value) {
+  uint8_t bytes[5];
+  int n = 0;
+  do {
+    bytes[n] = value & 0x7f;
+    value >>= 7;
+    if (value) bytes[n] |= 0x80;
+    n++;
+  } while (value);
+  if (s_replay.length + n > REPLAY_ARENA_BYTES) return false;
+  for (int i = 0; i < n; ++i) s_replay.data[s_replay.length++] = bytes[i];
+  return true;
+}
+
+static bool get_varint(ReplayCursor *cursor, uint32_t *out) {
+  uint32_t value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (cursor->pos >= cursor->replay->length) return false;
+    uint8_t byte = cursor->replay->data[cursor->pos++];
+    value |= (uint32_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *out = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+void replay_set_recording(bool enabled) {
+  s_recording_enabled = enabled;
+  if (!enabled) s_recording = false;
+}
+
+void replay_record_start(uint8_t mode, uint32_t seed, uint16_t start_len, uint32_t now_ms) {
+  if (!s_recording_enabled) return;
+  s_replay.version = REPLAY_VERSION;
+  s_replay.mode = mode;
+  s_replay.flags = 0;
+  s_replay.reserved = 0;
+  s_replay.start_len = start_len;
+  s_replay.end_len = start_len;
+  s_replay.seed = seed;
+  s_replay.length = 0;
+  s_replay.events = 0;
+  s_last_ms = now_ms;
+  s_recording = true;
+}
+
+void replay_record_event(ReplayCode code, uint8_t ext, uint32_t now_ms) {
+  if (!s_recording) return;
+  uint32_t delta = now_ms - s_last_ms;
+  // the 2-bit code rides in the low bits; deltas past 2^30 ms are clamped
+  if (delta > (UINT32_MAX >> 2)) delta = UINT32_MAX >> 2;
+  uint16_t rollback = s_replay.length;
+  if (!put_varint(delta << 2 | (code & 3)) ||
+      (code == REPLAY_CODE_EXT && s_replay.length + 1 > REPLAY_ARENA_BYTES)) {
+    // keep what fits: a prefix still reproduces the run up to here
+    s_replay.length = rollback;
+    s_replay.flags |= REPLAY_FLAG_TRUNCATED;
+    s_recording = false;
+    return;
+  }
+  if (code == REPLAY_CODE_EXT) s_replay.data[s_replay.length++] = ext;
+  s_replay.events++;
+  s_last_ms = now_ms;
+}
+
+void replay_record_end(bool won, uint16_t end_len) {
+  if (!s_recording_enabled || s_replay.version != REPLAY_VERSION) return;
+  // a truncated recording still learns how the run ended
+  if (!s_recording && !(s_replay.flags & REPLAY_FLAG_TRUNCATED)) return;
+  s_replay.flags |= REPLAY_FLAG_ENDED | (won ? REPLAY_FLAG_WON : 0);
+  s_replay.end_len = end_len;
+  s_recording = false;
+}
+
+const Replay *replay_get(void) {
+  return &s_replay;
+}
+
+void replay_cursor_init(ReplayCursor *cursor, const Replay *replay) {
+  *cursor = (ReplayCursor) { .replay = replay };
+}
+
+bool replay_next(ReplayCursor *cursor, ReplayEvent *out) {
+  uint32_t value;
+  if (!get_varint(cursor, &value)) return false;
+  out->code = value & 3;
+  out->delta_ms = value >> 2;
+  out->ext = 0;
+  if (out->code == REPLAY_CODE_EXT) {
+    if (cursor->pos >= cursor->replay->length) return false;
+    out->ext = cursor->replay->data[cursor->pos++];
+  }
+  cursor->at_ms += out->delta_ms;
+  out->at_ms = cursor->at_ms;
+  return true;
+}
+
+bool replay_valid(const Replay *replay) {
+  if (replay->version != REPLAY_VERSION || replay->length > REPLAY_ARENA_BYTES) return false;
+  if (replay->start_len < 1) return false;
+  ReplayCursor cursor;
+  ReplayEvent event;
+  uint16_t events = 0;
+  replay_cursor_init(&cursor, replay);
+  while (replay_next(&cursor, &event)) events++;
+  return cursor.pos == replay->length && events == replay->events;
+}
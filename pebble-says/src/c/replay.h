@@ -0,0 +1,80 @@
+#pragma once
+
+// Compact record of one run for reproducing player reports. The core
+// records the seed and every input as it happens; each event is one
+// LEB128 varint of (ms since the previous event << 2 | code), so a press
+// costs two bytes at human speeds and a long endless run fits in the fixed
+// arena. Platform-free: the watch and the host play a replay back through
+// the same core entry points.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define REPLAY_VERSION 1
+#ifndef REPLAY_ARENA_BYTES
+#define REPLAY_ARENA_BYTES 512  // ~250 presses; recording stops when full
+#endif
+
+// 2-bit event codes; the three buttons match SequenceButton
+typedef enum {
+  REPLAY_CODE_UP = 0,
+  REPLAY_CODE_SELECT = 1,
+  REPLAY_CODE_DOWN = 2,
+  REPLAY_CODE_EXT = 3,  // followed by one ReplayExt byte
+} ReplayCode;
+
+typedef enum {
+  REPLAY_EXT_FOCUS_LOST = 0,
+  REPLAY_EXT_FOCUS_REGAINED,
+} ReplayExt;
+
+typedef enum {
+  REPLAY_FLAG_ENDED = 1 << 0,      // recorded up to game over
+  REPLAY_FLAG_WON = 1 << 1,
+  REPLAY_FLAG_TRUNCATED = 1 << 2,  // the arena filled up before the end
+} ReplayFlag;
+
+typedef struct {
+  uint8_t version;
+  uint8_t mode;       // GameMode
+  uint8_t flags;      // ReplayFlag
+  uint8_t reserved;
+  uint16_t start_len; // sequence length of the first round (1, or resumed)
+  uint16_t end_len;   // sequence length at game over
+  uint32_t seed;
+  uint16_t length;    // bytes of data used
+  uint16_t events;
+  uint8_t data[REPLAY_ARENA_BYTES];
+} Replay;
+
+// Bytes worth storing or sending: the header plus the used data.
+static inline uint32_t replay_size(const Replay *replay) {
+  return (uint32_t)(sizeof(Replay) - REPLAY_ARENA_BYTES) + replay->length;
+}
+
+// Recorder, driven by the core. Disabled, every call is a no-op; the
+// recording of the last run stays readable.
+void replay_set_recording(bool enabled);
+void replay_record_start(uint8_t mode, uint32_t seed, uint16_t start_len, uint32_t now_ms);
+void replay_record_event(ReplayCode code, uint8_t ext, uint32_t now_ms);
+void replay_record_end(bool won, uint16_t end_len);
+const Replay *replay_get(void);
+
+typedef struct {
+  uint8_t code;    // ReplayCode
+  uint8_t ext;     // ReplayExt, for REPLAY_CODE_EXT
+  uint32_t at_ms;  // since the start of the recording
+  uint32_t delta_ms;
+} ReplayEvent;
+
+typedef struct {
+  const Replay *replay;
+  uint16_t pos;
+  uint32_t at_ms;
+} ReplayCursor;
+
+void replay_cursor_init(ReplayCursor *cursor, const Replay *replay);
+// False at the end of the data or on a malformed event.
+bool replay_next(ReplayCursor *cursor, ReplayEvent *out);
+// Header and data consistent enough to play back.
+bool replay_valid(const Replay *replay);
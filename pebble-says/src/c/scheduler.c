@@ -0,0 +1,181 @@
+#include "scheduler.h"
+
+#include <stddef.h>
+
+typedef struct {
+  SchedulerCallback cb;
+  void *data;
+  uint32_t due_ms;  // remaining ms instead while the scheduler is paused
+  uint16_t gen;
+  bool active;
+} SchedulerEntry;
+
+static const SchedulerBackend *s_backend;
+static SchedulerEntry s_entries[SCHEDULER_MAX_ENTRIES];
+static bool s_armed = false;
+static uint32_t s_armed_due_ms = 0;
+static bool s_dispatching = false;
+static bool s_paused = false;
+
+// wrap-safe "a is before b" for 32-bit millisecond timestamps
+static inline bool due_before(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) < 0;
+}
+
+static SchedulerHandle make_handle(int slot) {
+  return ((uint32_t)s_entries[slot].gen << 8) | (uint32_t)(slot + 1);
+}
+
+static SchedulerEntry *lookup(SchedulerHandle handle) {
+  int slot = (int)(handle & 0xff) - 1;
+  if (slot < 0 || slot >= SCHEDULER_MAX_ENTRIES) return NULL;
+  SchedulerEntry *entry = &s_entries[slot];
+  if (!entry->active || entry->gen != (uint16_t)(handle >> 8)) return NULL;
+  return entry;
+}
+
+static void release(SchedulerEntry *entry) {
+  entry->active = false;
+  entry->gen++;
+  if (entry->gen == 0) entry->gen = 1; // keep handles non-zero
+}
+
+static SchedulerEntry *earliest(void) {
+  SchedulerEntry *best = NULL;
+  for (int i = 0; i < SCHEDULER_MAX_ENTRIES; ++i) {
+    SchedulerEntry *entry = &s_entries[i];
+    if (entry->active && (!best || due_before(entry->due_ms, best->due_ms))) {
+      best = entry;
+    }
+  }
+  return best;
+}
+
+// Points the backing timer at the earliest deadline, touching it only when
+// that deadline actually changed.
+static void rearm(void) {
+  if (s_dispatching || s_paused) return; // dispatch re-arms once when it finishes
+  SchedulerEntry *next = earliest();
+  if (!next) {
+    if (s_armed) {
+      s_backend->disarm();
+      s_armed = false;
+    }
+    return;
+  }
+  if (s_armed && next->due_ms == s_armed_due_ms) return;
+  uint32_t now = s_backend->now_ms();
+  uint32_t delay = due_before(now, next->due_ms) ? next->due_ms - now : 0;
+  s_backend->arm(delay);
+  s_armed = true;
+  s_armed_due_ms = next->due_ms;
+}
+
+SchedulerHandle scheduler_add(uint32_t delay_ms, SchedulerCallback cb, void *data) {
+  int free_slot = -1;
+  int slot = -1;
+  for (int i = 0; i < SCHEDULER_MAX_ENTRIES; ++i) {
+    if (s_entries[i].active) {
+      if (s_entries[i].cb == cb && s_entries[i].data == data) {
+        slot = i;
+        break;
+      }
+    } else if (free_slot < 0) {
+      free_slot = i;
+    }
+  }
+  if (slot < 0) slot = free_slot;
+  if (slot < 0) return SCHEDULER_HANDLE_NONE; // table full
+
+  SchedulerEntry *entry = &s_entries[slot];
+  entry->cb = cb;
+  entry->data = data;
+  entry->due_ms = s_paused ? delay_ms : s_backend->now_ms() + delay_ms;
+  entry->active = true;
+  rearm();
+  return make_handle(slot);
+}
+
+void scheduler_cancel(SchedulerHandle *handle) {
+  SchedulerEntry *entry = lookup(*handle);
+  *handle = SCHEDULER_HANDLE_NONE;
+  if (!entry) return;
+  release(entry);
+  rearm();
+}
+
+void scheduler_cancel_all(void) {
+  for (int i = 0; i < SCHEDULER_MAX_ENTRIES; ++i) {
+    if (s_entries[i].active) release(&s_entries[i]);
+  }
+  rearm();
+}
+
+bool scheduler_is_pending(SchedulerHandle handle) {
+  return lookup(handle) != NULL;
+}
+
+int scheduler_pending_count(void) {
+  int count = 0;
+  for (int i = 0; i < SCHEDULER_MAX_ENTRIES; ++i) {
+    if (s_entries[i].active) count++;
+  }
+  return count;
+}
+
+void scheduler_pause(void) {
+  if (s_paused) return;
+  uint32_t now = s_backend->now_ms();
+  for (int i = 0; i < SCHEDULER_MAX_ENTRIES; ++i) {
+    SchedulerEntry *entry = &s_entries[i];
+    if (!entry->active) continue;
+    entry->due_ms = due_before(now, entry->due_ms) ? entry->due_ms - now : 0;
+  }
+  s_paused = true;
+  if (s_armed) {
+    s_backend->disarm();
+    s_armed = false;
+  }
+}
+
+void scheduler_resume(void) {
+  if (!s_paused) return;
+  uint32_t now = s_backend->now_ms();
+  for (int i = 0; i < SCHEDULER_MAX_ENTRIES; ++i) {
+    SchedulerEntry *entry = &s_entries[i];
+    if (entry->active) entry->due_ms += now;
+  }
+  s_paused = false;
+  rearm();
+}
+
+bool scheduler_is_paused(void) {
+  return s_paused;
+}
+
+void scheduler_dispatch(void) {
+  // the backing timer has fired, so nothing is armed any more
+  s_armed = false;
+  if (s_paused) return; // raced the disarm; resume re-arms
+  s_dispatching = true;
+  uint32_t now = s_backend->now_ms();
+  SchedulerEntry *entry;
+  while ((entry = earliest()) && !due_before(now, entry->due_ms)) {
+    SchedulerCallback cb = entry->cb;
+    void *data = entry->data;
+    release(entry);
+    cb(data);
+  }
+  s_dispatching = false;
+  rearm();
+}
+
+void scheduler_init(const SchedulerBackend *backend) {
+  s_backend = backend;
+  for (int i = 0; i < SCHEDULER_MAX_ENTRIES; ++i) {
+    s_entries[i] = (SchedulerEntry) { .gen = 1 };
+  }
+  s_armed = false;
+  s_dispatching = false;
+  s_paused = false;
+}
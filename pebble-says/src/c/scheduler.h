@@ -0,0 +1,45 @@
+#pragma once
+
+// Deadline queue multiplexed onto a single backing timer. Entries are kept
+// in a small fixed table; the backend is only re-armed when the earliest
+// deadline changes. Platform-free: the backend supplies the clock and the
+// one real timer (an AppTimer on the watch, a mocked clock on the host).
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SCHEDULER_MAX_ENTRIES 8
+
+typedef void (*SchedulerCallback)(void *data);
+
+// Generation-tagged handle. Cancelling a handle whose entry already fired
+// or was replaced is a harmless no-op, so callers never need to clear
+// handles from inside their callbacks.
+typedef uint32_t SchedulerHandle;
+#define SCHEDULER_HANDLE_NONE 0
+
+typedef struct {
+  uint32_t (*now_ms)(void);
+  void (*arm)(uint32_t delay_ms);  // (re)arm the backing timer, replacing any pending one
+  void (*disarm)(void);
+} SchedulerBackend;
+
+void scheduler_init(const SchedulerBackend *backend);
+
+// Schedules cb(data) delay_ms from now. An entry with the same callback and
+// data is coalesced: its deadline moves and its handle stays valid.
+SchedulerHandle scheduler_add(uint32_t delay_ms, SchedulerCallback cb, void *data);
+void scheduler_cancel(SchedulerHandle *handle);
+void scheduler_cancel_all(void);
+bool scheduler_is_pending(SchedulerHandle handle);
+int scheduler_pending_count(void);
+
+// Freezes every pending deadline: each entry keeps its remaining time and
+// the backing timer is disarmed, so nothing wakes the CPU until resume.
+// Entries added meanwhile wait from the resume. Both are idempotent.
+void scheduler_pause(void);
+void scheduler_resume(void);
+bool scheduler_is_paused(void);
+
+// Runs every entry that is due. Called by the backend when its timer fires.
+void scheduler_dispatch(void);
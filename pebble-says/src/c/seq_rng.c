@@ -0,0 +1,38 @@
+#include "seq_rng.h"
+
+// lowbias32 integer finaliser (good avalanche, two multiplies)
+static inline uint32_t mix32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352dU;
+  x ^= x >> 15;
+  x *= 0x846ca68bU;
+  x ^= x >> 16;
+  return x;
+}
+
+void seq_rng_seed(SeqRng *rng, uint32_t seed) {
+  rng->key = mix32(seed ^ 0x9e3779b9U);
+  rng->index = 0;
+}
+
+void seq_rng_jump(SeqRng *rng, uint32_t index) {
+  rng->index = index;
+}
+
+int seq_rng_at(const SeqRng *rng, uint32_t index) {
+  uint32_t h = mix32(index ^ rng->key);
+  // Rejection sampling on 2-bit chunks: take the lowest chunk that isn't 3,
+  // so 0..2 stay equally likely with no modulo bias. A hash made only of 3s
+  // happens once in 2^32 and is simply rehashed.
+  while (h == 0xffffffffU) h = mix32(h + rng->key);
+  while ((h & 3) == 3) h >>= 2;
+  return (int)(h & 3);
+}
+
+int seq_rng_next(SeqRng *rng) {
+  return seq_rng_at(rng, rng->index++);
+}
+
+uint32_t seq_rng_next_seed(uint32_t seed) {
+  return mix32(seed + 0x9e3779b9U);
+}
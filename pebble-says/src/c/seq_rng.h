@@ -0,0 +1,20 @@
+#pragma once
+
+// Seeded generator for sequence steps. Counter-based: step n is a pure
+// function of (seed, n), so any step can be produced or jumped to in O(1)
+// and a seed alone reproduces a whole game. Output is an unbiased 0..2.
+
+#include <stdint.h>
+
+typedef struct {
+  uint32_t key;    // pre-mixed seed
+  uint32_t index;  // next step produced by seq_rng_next()
+} SeqRng;
+
+void seq_rng_seed(SeqRng *rng, uint32_t seed);
+void seq_rng_jump(SeqRng *rng, uint32_t index);
+int seq_rng_next(SeqRng *rng);
+int seq_rng_at(const SeqRng *rng, uint32_t index);
+
+// Derives a well-spread seed for the following game from the current one.
+uint32_t seq_rng_next_seed(uint32_t seed);
@@ -0,0 +1,114 @@
+#include "stats.h"
+
+#include "game_log.h"
+#include "persist_keys.h"
+#include "scheduler.h"
+
+// Blobs are written as-is; both stay well under PERSIST_DATA_MAX_LENGTH.
+typedef struct {
+  uint8_t version;
+  uint8_t reserved[3];
+  Stats stats;
+} StatsBlob;
+
+typedef struct {
+  uint8_t version;
+  uint8_t buckets;
+  uint8_t reserved[2];
+  uint32_t counts[HISTOGRAM_MAX_BUCKETS];
+} StatsHistBlob;
+
+_Static_assert(sizeof(StatsBlob) <= PERSIST_DATA_MAX_LENGTH, "stats blob too large");
+_Static_assert(sizeof(StatsHistBlob) <= PERSIST_DATA_MAX_LENGTH, "histogram blob too large");
+
+static Stats s_stats;
+static StatsHistBlob s_saved_reaction;  // counts from earlier sessions, as loaded
+static StatsHistBlob s_saved_round;
+static bool s_dirty;
+static bool s_new_best;
+static time_t s_last_write;
+static SchedulerHandle s_write_timer;
+
+static void load_hist(PersistKey key, StatsHistBlob *blob) {
+  *blob = (StatsHistBlob) { .version = STATS_VERSION };
+  StatsHistBlob saved;
+  if (persist_read_data(key, &saved, sizeof(saved)) == (int)sizeof(saved) &&
+      saved.version == STATS_VERSION && saved.buckets <= HISTOGRAM_MAX_BUCKETS) {
+    *blob = saved;
+  }
+}
+
+// the session histograms are never reset, so every write is loaded + session
+static void write_hist(PersistKey key, const StatsHistBlob *saved, const Histogram *session) {
+  StatsHistBlob blob = { .version = STATS_VERSION, .buckets = session->buckets };
+  for (int i = 0; i < HISTOGRAM_MAX_BUCKETS; ++i) {
+    uint32_t base = saved->buckets == session->buckets ? saved->counts[i] : 0;
+    uint32_t sum = base + session->counts[i];
+    blob.counts[i] = sum < base ? UINT32_MAX : sum;
+  }
+  persist_write_data(key, &blob, sizeof(blob));
+}
+
+void stats_init(void) {
+  s_stats = (Stats) { 0 };
+  StatsBlob blob;
+  if (persist_read_data(PERSIST_KEY_STATS, &blob, sizeof(blob)) == (int)sizeof(blob) &&
+      blob.version == STATS_VERSION) {
+    s_stats = blob.stats;
+  }
+  load_hist(PERSIST_KEY_REACTION_HIST, &s_saved_reaction);
+  load_hist(PERSIST_KEY_ROUND_HIST, &s_saved_round);
+  s_dirty = false;
+  s_new_best = false;
+  s_last_write = time(NULL);
+}
+
+const Stats *stats_get(void) {
+  return &s_stats;
+}
+
+int stats_best(GameMode mode) {
+  if (mode < 0 || mode >= GAME_MODE_COUNT) return 0;
+  return s_stats.best[mode];
+}
+
+bool stats_record_game(const GameState *game, bool won) {
+  if (game->mode < 0 || game->mode >= GAME_MODE_COUNT) return false;
+  s_stats.games[game->mode]++;
+  s_stats.rounds += (uint32_t)game->round;
+  if (won) s_stats.wins++;
+  bool best = game->round > s_stats.best[game->mode];
+  if (best) {
+    s_stats.best[game->mode] = (uint16_t)game->round;
+    s_new_best = true;
+  }
+  s_dirty = true;
+  return best;
+}
+
+void stats_flush(void) {
+  scheduler_cancel(&s_write_timer);
+  if (!s_dirty) return;
+  StatsBlob blob = { .version = STATS_VERSION, .stats = s_stats };
+  persist_write_data(PERSIST_KEY_STATS, &blob, sizeof(blob));
+  write_hist(PERSIST_KEY_REACTION_HIST, &s_saved_reaction, game_get_reaction_histogram());
+  write_hist(PERSIST_KEY_ROUND_HIST, &s_saved_round, game_get_round_histogram());
+  GAME_LOG_DEBUG("Stats written");
+  s_dirty = false;
+  s_new_best = false;
+  s_last_write = time(NULL);
+}
+
+static void pause_write(void *data) {
+  if (!s_new_best && time(NULL) - s_last_write < STATS_MIN_WRITE_INTERVAL_S) return;  // unload will catch it
+  stats_flush();
+}
+
+void stats_schedule_write(void) {
+  if (!s_dirty) return;
+  s_write_timer = scheduler_add(STATS_PAUSE_WRITE_MS, pause_write, NULL);
+}
+
+void stats_cancel_write(void) {
+  scheduler_cancel(&s_write_timer);
+}
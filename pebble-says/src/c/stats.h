@@ -0,0 +1,37 @@
+#pragma once
+
+// Lifetime stats and high scores. Kept in RAM while the app runs and only
+// written behind: at unload, or during a natural pause on the game-over
+// screen when there is something worth saving (a new best, or the last
+// write is old). Never written on the input path and never per round.
+// Histogram snapshots add the current session's counts to the saved ones.
+
+#include <pebble.h>
+
+#include "game_core.h"
+
+#define STATS_VERSION 1
+#define STATS_PAUSE_WRITE_MS 4000      // idle on the game-over screen this long
+#define STATS_MIN_WRITE_INTERVAL_S 300 // pause writes without a new best
+
+typedef struct {
+  uint16_t best[GAME_MODE_COUNT];   // highest round reached per mode
+  uint32_t games[GAME_MODE_COUNT];
+  uint32_t wins;
+  uint32_t rounds;                  // rounds reached over all games
+} Stats;
+
+// one persist read per key
+void stats_init(void);
+const Stats *stats_get(void);
+int stats_best(GameMode mode);
+
+// RAM only; returns true for a new best
+bool stats_record_game(const GameState *game, bool won);
+
+// A game ended: write after STATS_PAUSE_WRITE_MS if still idle and worth it.
+void stats_schedule_write(void);
+// A game started: the pause is over.
+void stats_cancel_write(void);
+// Write now if anything changed (unload).
+void stats_flush(void);
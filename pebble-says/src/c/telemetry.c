@@ -0,0 +1,180 @@
+#include "telemetry.h"
+
+#include "game_log.h"
+#include "scheduler.h"
+
+typedef struct {
+  uint32_t seed;
+  uint8_t mode;
+  uint8_t won;
+  uint16_t length;
+  uint16_t duration_ds;
+} TelemetryGame;
+
+static TelemetryGame s_queue[TELEMETRY_QUEUE_SLOTS];
+static uint8_t s_head;
+static uint8_t s_count;
+static uint8_t s_in_flight;  // records in the message awaiting ACK/NACK
+static uint8_t s_retries;
+static bool s_playing;
+static uint32_t s_batch;
+static SchedulerHandle s_flush_timer;
+static TelemetryStats s_stats;
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+  p = put_u16(p, (uint16_t)v);
+  return put_u16(p, (uint16_t)(v >> 16));
+}
+
+static uint16_t encode_histogram(uint8_t *out, const Histogram *h) {
+  uint8_t *p = out;
+  for (int i = 0; i < h->buckets; ++i) {
+    p = put_u16(p, h->counts[i] > UINT16_MAX ? UINT16_MAX : (uint16_t)h->counts[i]);
+  }
+  return (uint16_t)(p - out);
+}
+
+// Games that fit in one outbox next to the header tuples and histograms.
+static int batch_capacity(void) {
+  static int s_capacity;
+  if (!s_capacity) {
+    uint32_t outbox = app_message_outbox_size_maximum();
+    if (outbox > TELEMETRY_OUTBOX_SIZE) outbox = TELEMETRY_OUTBOX_SIZE;
+    uint32_t fixed = dict_calc_buffer_size(5, sizeof(uint8_t), sizeof(uint32_t),
+                                           HISTOGRAM_MAX_BUCKETS * 2, HISTOGRAM_MAX_BUCKETS * 2, 0);
+    int capacity = outbox > fixed ? (int)((outbox - fixed) / TELEMETRY_GAME_BYTES) : 1;
+    if (capacity < 1) capacity = 1;
+    if (capacity > TELEMETRY_QUEUE_SLOTS) capacity = TELEMETRY_QUEUE_SLOTS;
+    s_capacity = capacity;
+  }
+  return s_capacity;
+}
+
+static void schedule_flush(uint32_t delay_ms);
+
+// Backs off after a NACK or an outbox that wouldn't take the batch; after
+// TELEMETRY_MAX_RETRIES in a row the queue waits for the next game over,
+// so a missing phone doesn't keep waking the watch.
+static void retry_later(void) {
+  if (s_retries >= TELEMETRY_MAX_RETRIES) {
+    s_retries = 0;
+    return;
+  }
+  schedule_flush(TELEMETRY_RETRY_MS << s_retries);
+  s_retries++;
+}
+
+static void send_batch(void *data) {
+  if (s_playing || s_in_flight || !s_count) return;
+  if (!connection_service_peek_pebble_app_connection()) return;  // next game over tries again
+  DictionaryIterator *iter;
+  if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+    // outbox busy with something else: back off like a NACK
+    s_stats.send_errors++;
+    retry_later();
+    return;
+  }
+  int n = s_count < batch_capacity() ? s_count : batch_capacity();
+  uint8_t games[TELEMETRY_QUEUE_SLOTS * TELEMETRY_GAME_BYTES];
+  uint8_t *p = games;
+  for (int i = 0; i < n; ++i) {
+    const TelemetryGame *g = &s_queue[(s_head + i) % TELEMETRY_QUEUE_SLOTS];
+    p = put_u32(p, g->seed);
+    *p++ = g->mode;
+    *p++ = g->won;
+    p = put_u16(p, g->length);
+    p = put_u16(p, g->duration_ds);
+  }
+  uint8_t hist[HISTOGRAM_MAX_BUCKETS * 2];
+  dict_write_uint8(iter, MESSAGE_KEY_TelemetryVersion, TELEMETRY_VERSION);
+  dict_write_uint32(iter, MESSAGE_KEY_TelemetryBatch, s_batch);
+  dict_write_data(iter, MESSAGE_KEY_TelemetryGames, games, (uint16_t)(p - games));
+  dict_write_data(iter, MESSAGE_KEY_TelemetryReaction, hist,
+                  encode_histogram(hist, game_get_reaction_histogram()));
+  dict_write_data(iter, MESSAGE_KEY_TelemetryRoundTime, hist,
+                  encode_histogram(hist, game_get_round_histogram()));
+  if (app_message_outbox_send() == APP_MSG_OK) {
+    s_in_flight = (uint8_t)n;
+  } else {
+    s_stats.send_errors++;
+    retry_later();
+  }
+}
+
+static void schedule_flush(uint32_t delay_ms) {
+  s_flush_timer = scheduler_add(delay_ms, send_batch, NULL);
+}
+
+static void outbox_sent(DictionaryIterator *iter, void *context) {
+  if (!s_in_flight) return;
+  s_head = (s_head + s_in_flight) % TELEMETRY_QUEUE_SLOTS;
+  s_count -= s_in_flight;
+  s_stats.games += s_in_flight;
+  s_stats.messages++;
+  s_in_flight = 0;
+  s_retries = 0;
+  s_batch++;
+  // keep draining, one message in flight at a time
+  if (s_count) schedule_flush(0);
+}
+
+static void outbox_failed(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+  if (!s_in_flight) return;
+  s_in_flight = 0;
+  s_stats.nacks++;
+  GAME_LOG_DEBUG("Telemetry batch %lu failed (%d), retry %d", (unsigned long)s_batch, (int)reason, s_retries);
+  retry_later();
+}
+
+void telemetry_record_game(const GameState *game, bool won, uint32_t duration_ms) {
+  if (s_count == TELEMETRY_QUEUE_SLOTS) {
+    if (s_in_flight == s_count) {
+      // every slot is in the message being sent: drop the new record instead
+      s_stats.dropped++;
+      return;
+    }
+    // the oldest record that is not in flight makes room
+    int victim = (s_head + s_in_flight) % TELEMETRY_QUEUE_SLOTS;
+    for (int i = 0; i < s_count - s_in_flight - 1; ++i) {
+      s_queue[(victim + i) % TELEMETRY_QUEUE_SLOTS] = s_queue[(victim + i + 1) % TELEMETRY_QUEUE_SLOTS];
+    }
+    s_count--;
+    s_stats.dropped++;
+  }
+  uint32_t duration_ds = duration_ms / 100;
+  s_queue[(s_head + s_count) % TELEMETRY_QUEUE_SLOTS] = (TelemetryGame) {
+    .seed = game->seed,
+    .mode = (uint8_t)game->mode,
+    .won = won,
+    .length = (uint16_t)game->seq_len,
+    .duration_ds = duration_ds > UINT16_MAX ? UINT16_MAX : (uint16_t)duration_ds,
+  };
+  s_count++;
+  s_stats.queued++;
+}
+
+void telemetry_set_playing(bool playing) {
+  s_playing = playing;
+  if (playing) {
+    scheduler_cancel(&s_flush_timer);
+  } else if (s_count) {
+    s_retries = 0;
+    schedule_flush(TELEMETRY_FLUSH_DELAY_MS);
+  }
+}
+
+const TelemetryStats *telemetry_get_stats(void) {
+  return &s_stats;
+}
+
+void telemetry_init(void) {
+  app_message_register_outbox_sent(outbox_sent);
+  app_message_register_outbox_failed(outbox_failed);
+  app_message_open(TELEMETRY_INBOX_SIZE, TELEMETRY_OUTBOX_SIZE);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Session telemetry for the pkjs companion (src/pkjs/index.js). Finished
+// games are queued in RAM and shipped in batches: each AppMessage carries
+// as many packed game records as fit the outbox, plus the current reaction
+// and round-time histograms. Nothing is sent while a game is running; a
+// batch goes out only when the outbox is idle, a NACK or a refused outbox
+// is retried with exponential backoff, and a full queue drops its oldest
+// record.
+//
+// Wire format: little-endian, TELEMETRY_GAME_BYTES per game:
+//   u32 seed, u8 mode, u8 won, u16 length, u16 duration (100 ms units)
+// Histograms are u16 bucket counts (saturating), in bucket order.
+
+#include <pebble.h>
+
+#include "game_core.h"
+
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_QUEUE_SLOTS 16
+#define TELEMETRY_GAME_BYTES 10
+#define TELEMETRY_OUTBOX_SIZE 256
+#define TELEMETRY_INBOX_SIZE 64
+#define TELEMETRY_FLUSH_DELAY_MS 1500  // after game over, once the result is on screen
+#define TELEMETRY_RETRY_MS 1000
+#define TELEMETRY_MAX_RETRIES 5         // then wait for the next game over
+
+typedef struct {
+  uint32_t queued;
+  uint32_t dropped;   // overwritten while the queue was full
+  uint32_t messages;  // acked batches
+  uint32_t games;     // records delivered
+  uint32_t nacks;
+  uint32_t send_errors;  // outbox refused to begin or send a batch
+} TelemetryStats;
+
+// Opens AppMessage; call once, after the first frame (nothing on the title
+// screen needs it, so it stays off the launch path).
+void telemetry_init(void);
+
+// Queues a finished game. Cheap enough for the input path: no sending.
+void telemetry_record_game(const GameState *game, bool won, uint32_t duration_ms);
+
+// Playing suspends sending; becoming idle schedules a flush.
+void telemetry_set_playing(bool playing);
+const TelemetryStats *telemetry_get_stats(void);
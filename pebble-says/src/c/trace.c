@@ -0,0 +1,66 @@
+#include "trace.h"
+
+#include <stddef.h>
+
+static TraceRecord s_ring[TRACE_SLOTS];
+static int s_head;   // next slot to write
+static int s_count;
+static uint32_t s_dropped;
+static uint32_t (*s_now_ms)(void);
+
+void trace_init(uint32_t (*now_ms)(void)) {
+  s_now_ms = now_ms;
+  trace_clear();
+}
+
+void trace_record(TraceEvent event, uint8_t a, int16_t b) {
+  TraceRecord *r = &s_ring[s_head];
+  r->t_ms = s_now_ms ? s_now_ms() : 0;
+  r->event = (uint8_t)event;
+  r->a = a;
+  r->b = b;
+  s_head = (s_head + 1) % TRACE_SLOTS;
+  if (s_count < TRACE_SLOTS) s_count++;
+  else s_dropped++;
+}
+
+void trace_clear(void) {
+  s_head = 0;
+  s_count = 0;
+  s_dropped = 0;
+}
+
+int trace_count(void) {
+  return s_count;
+}
+
+uint32_t trace_dropped(void) {
+  return s_dropped;
+}
+
+void trace_dump(TraceSink sink, void *context) {
+  int start = (s_head - s_count + TRACE_SLOTS) % TRACE_SLOTS;
+  for (int i = 0; i < s_count; ++i) {
+    sink(&s_ring[(start + i) % TRACE_SLOTS], context);
+  }
+}
+
+const char *trace_event_name(uint8_t event) {
+  static const char *const names[TRACE_EV_COUNT] = {
+    [TRACE_EV_NEW_GAME] = "new_game",
+    [TRACE_EV_STEP] = "step",
+    [TRACE_EV_ROUND] = "round",
+    [TRACE_EV_PRESS] = "press",
+    [TRACE_EV_QUEUED] = "queued",
+    [TRACE_EV_WRONG] = "wrong",
+    [TRACE_EV_WIN] = "win",
+    [TRACE_EV_GAME_OVER] = "game_over",
+    [TRACE_EV_LATE_EDGE] = "late_edge",
+    [TRACE_EV_HEAP_USED] = "heap_used",
+    [TRACE_EV_HEAP_FREE] = "heap_free",
+    [TRACE_EV_FIRST_FRAME] = "first_frame",
+    [TRACE_EV_FOCUS] = "focus",
+  };
+  if (event >= TRACE_EV_COUNT || names[event] == NULL) return "?";
+  return names[event];
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// In-RAM ring of compact event records for tracing the timing-sensitive
+// paths. Recording stores an id, two small arguments and a timestamp;
+// nothing is formatted until the ring is dumped. Platform-free, and
+// compiled out with the rest of the debug tooling in release builds.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef GAME_TRACE_ENABLED
+#ifdef PEBBLE_SAYS_RELEASE
+#define GAME_TRACE_ENABLED 0
+#else
+#define GAME_TRACE_ENABLED 1
+#endif
+#endif
+
+#define TRACE_SLOTS 64  // 8 bytes each
+
+typedef enum {
+  TRACE_EV_NEW_GAME = 1,  // a = mode, b = low 16 bits of the seed
+  TRACE_EV_STEP,          // a = button, b = sequence length
+  TRACE_EV_ROUND,         // a = show ms / 4, b = round
+  TRACE_EV_PRESS,         // a = button, b = input index
+  TRACE_EV_QUEUED,        // a = button, b = queue depth
+  TRACE_EV_WRONG,         // a = button pressed, b = input index
+  TRACE_EV_WIN,           // b = sequence length
+  TRACE_EV_GAME_OVER,     // b = round
+  TRACE_EV_LATE_EDGE,     // a = timer, b = lateness in ms
+  TRACE_EV_HEAP_USED,     // a = MemPoint, b = bytes / 4
+  TRACE_EV_HEAP_FREE,     // a = MemPoint, b = bytes / 4
+  TRACE_EV_FIRST_FRAME,   // b = ms from init to the first frame
+  TRACE_EV_FOCUS,         // a = 1 regained / 0 lost, b = show index (-1 when not showing)
+  TRACE_EV_COUNT
+} TraceEvent;
+
+typedef struct {
+  uint32_t t_ms;
+  uint8_t event;
+  uint8_t a;
+  int16_t b;
+} TraceRecord;
+
+typedef void (*TraceSink)(const TraceRecord *record, void *context);
+
+// Timestamps come from now_ms; records made before init are stamped 0.
+void trace_init(uint32_t (*now_ms)(void));
+void trace_record(TraceEvent event, uint8_t a, int16_t b);
+void trace_clear(void);
+int trace_count(void);
+uint32_t trace_dropped(void);  // records overwritten since the last clear
+
+// Calls sink for each record, oldest first.
+void trace_dump(TraceSink sink, void *context);
+const char *trace_event_name(uint8_t event);
+
+#if GAME_TRACE_ENABLED
+#define GAME_TRACE(event, a, b) trace_record((event), (uint8_t)(a), (int16_t)(b))
+#else
+#define GAME_TRACE(event, a, b) ((void)0)
+#endif
@@ -0,0 +1,83 @@
+// Phone-side companion: receives batched session telemetry from the watch
+// (src/c/telemetry.c) and keeps a bounded history in localStorage.
+//
+// Each message carries packed game records, little-endian:
+//   u32 seed, u8 mode, u8 won, u16 length, u16 duration (100 ms units)
+// plus the watch's current reaction and round-time histograms as u16
+// bucket counts. Bucket bounds mirror s_reaction_bounds / s_round_bounds
+// in src/c/game_core.c.
+
+var TELEMETRY_VERSION = 1;
+var GAME_BYTES = 10;
+var HISTORY_KEY = 'pebble-says-games';
+var HISTOGRAM_KEY = 'pebble-says-histograms';
+var MAX_HISTORY = 200;
+var MODES = ['classic', 'endless'];
+
+var REACTION_BOUNDS = [100, 150, 200, 250, 300, 350, 400, 500, 600, 750, 1000, 1300, 1700, 2500, 4000];
+var ROUND_BOUNDS = [500, 1000, 1500, 2000, 2500, 3000, 4000, 5000, 6000, 8000, 10000, 13000, 17000, 25000, 40000];
+
+function u16(bytes, i) {
+  return bytes[i] | (bytes[i + 1] << 8);
+}
+
+function u32(bytes, i) {
+  return (u16(bytes, i) + u16(bytes, i + 2) * 65536) >>> 0;
+}
+
+function decodeGames(bytes) {
+  var games = [];
+  for (var i = 0; i + GAME_BYTES <= bytes.length; i += GAME_BYTES) {
+    games.push({
+      seed: u32(bytes, i),
+      mode: MODES[bytes[i + 4]] || 'unknown',
+      won: bytes[i + 5] !== 0,
+      length: u16(bytes, i + 6),
+      durationMs: u16(bytes, i + 8) * 100
+    });
+  }
+  return games;
+}
+
+function decodeHistogram(bytes, bounds) {
+  var buckets = [];
+  for (var i = 0; i + 1 < bytes.length; i += 2) {
+    buckets.push({ upTo: i / 2 < bounds.length ? bounds[i / 2] : null, count: u16(bytes, i) });
+  }
+  return buckets;
+}
+
+function load(key, fallback) {
+  try {
+    var value = localStorage.getItem(key);
+    return value ? JSON.parse(value) : fallback;
+  } catch (e) {
+    return fallback;
+  }
+}
+
+function onTelemetry(payload) {
+  if (payload.TelemetryVersion !== TELEMETRY_VERSION) {
+    console.log('Pebble Says: ignoring telemetry version ' + payload.TelemetryVersion);
+    return;
+  }
+  var games = decodeGames(payload.TelemetryGames || []);
+  var history = load(HISTORY_KEY, []).concat(games);
+  if (history.length > MAX_HISTORY) history = history.slice(history.length - MAX_HISTORY);
+  localStorage.setItem(HISTORY_KEY, JSON.stringify(history));
+  // the histograms are cumulative on the watch: the latest snapshot wins
+  localStorage.setItem(HISTOGRAM_KEY, JSON.stringify({
+    reaction: decodeHistogram(payload.TelemetryReaction || [], REACTION_BOUNDS),
+    roundTime: decodeHistogram(payload.TelemetryRoundTime || [], ROUND_BOUNDS)
+  }));
+  console.log('Pebble Says: batch ' + payload.TelemetryBatch + ', ' + games.length +
+              ' games, ' + history.length + ' stored');
+}
+
+Pebble.addEventListener('ready', function() {
+  console.log('Pebble Says companion ready');
+});
+
+Pebble.addEventListener('appmessage', function(e) {
+  if (e.payload.TelemetryGames !== undefined) onTelemetry(e.payload);
+});
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Plays one fixed game on each platform emulator and writes the timings.
+
+The game is a replay: by default a simulated run from the seeded PRNG,
+recorded on the host by host/replay -w, or a run logged by a watch
+(--replay dump.txt, the "Replay ..." lines of the long-press Select dump).
+It is embedded into a benchmark build (PEBBLE_SAYS_BENCH_REPLAY, see
+src/c/benchmark.h), which plays it back a second after launch and logs
+"BENCH ..." lines:
+
+  frame_ms       render update proc
+  timer_late_ms  replay timer lateness against the recorded times
+  feedback_ms    replayed press to the end of the frame that shows it
+  edge_late_ms   sequence show/pause edge lateness
+  wakeup_ms, input_ms, edge_ms   profiler maxima per hook
+  heap           peak used, free at the end
+
+One report per platform goes to build/bench/<git describe>/<platform>.txt
+with a summary.txt beside them, so two builds compare with diff -r.
+Emulator timings are QEMU's, not a watch's: compare builds against each
+other, not against hardware.
+
+    python3 tools/emu_bench.py                       # from pebble-says/
+    python3 tools/emu_bench.py --seed 7 --platforms basalt chalk
+    python3 tools/emu_bench.py --replay watch_log.txt
+
+Needs the Pebble SDK's `pebble` tool with its emulators, and make and a C
+compiler for the host replay tool.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import time
+
+PLATFORMS = ['aplite', 'basalt', 'chalk', 'diorite', 'emery']
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BENCH_LINE = re.compile(r'BENCH (.*)$')
+REPLAY_LINE = re.compile(r'Replay ([0-9a-fA-F]+)')
+# summary columns: (report line, field after it)
+SUMMARY = [
+    ('frame_ms', 'mean'), ('frame_ms', 'p95'), ('frame_ms', 'max'),
+    ('timer_late_ms', 'p95'), ('feedback_ms', 'mean'), ('feedback_ms', 'p95'),
+    ('edge_late_ms', 'max'), ('heap', 'peak'),
+]
+
+
+def replay_hex(args):
+    if args.replay:
+        with open(args.replay) as f:
+            chunks = [m.group(1) for m in map(REPLAY_LINE.search, f) if m]
+        if not chunks:
+            sys.exit('{}: no "Replay" lines'.format(args.replay))
+        return ''.join(chunks)
+    subprocess.check_call(['make', '-C', os.path.join(ROOT, 'host'), '-s', 'replay'])
+    cmd = [os.path.join(ROOT, 'host', 'replay'), '-w', '-s', str(args.seed)]
+    if args.endless:
+        cmd.append('-E')
+    out = subprocess.check_output(cmd).decode()
+    return ''.join(REPLAY_LINE.findall(out))
+
+
+def build_label():
+    try:
+        return subprocess.check_output(['git', 'describe', '--always', '--dirty'], cwd=ROOT,
+                                       stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return time.strftime('%Y%m%d-%H%M%S')
+
+
+def run_platform(platform, timeout):
+    """Installs on the emulator and returns the BENCH lines, or None on timeout."""
+    proc = subprocess.Popen(['pebble', 'install', '--emulator', platform, '--logs'], cwd=ROOT,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    lines = []
+    deadline = time.time() + timeout
+    try:
+        # readline blocks, so the timeout is only checked between log lines;
+        # the app logs several a second while the game runs
+        for raw in iter(proc.stdout.readline, b''):
+            match = BENCH_LINE.search(raw.decode(errors='replace').rstrip())
+            if match:
+                lines.append(match.group(1))
+                if match.group(1) == 'done' or match.group(1).startswith('error'):
+                    return lines
+            if time.time() > deadline:
+                break
+        return None
+    finally:
+        proc.terminate()
+        proc.wait()
+        subprocess.call(['pebble', 'kill'], cwd=ROOT, stdout=subprocess.DEVNULL,
+                        stderr=subprocess.DEVNULL)
+
+
+def field(lines, name, key):
+    for line in lines:
+        words = line.split()
+        if words and words[0] == name and key in words[1:-1]:
+            return words[words.index(key) + 1]
+    return '-'
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('--platforms', nargs='+', default=PLATFORMS, choices=PLATFORMS)
+    parser.add_argument('--seed', type=int, default=1, help='seed of the simulated game')
+    parser.add_argument('--endless', action='store_true', help='simulate an endless-mode game')
+    parser.add_argument('--replay', help='watch log holding the replay to play instead')
+    parser.add_argument('--out', help='report directory (default build/bench/<git describe>)')
+    parser.add_argument('--timeout', type=int, default=300, help='seconds per platform')
+    parser.add_argument('--no-build', action='store_true', help='reuse the last benchmark build')
+    args = parser.parse_args()
+
+    hex_data = replay_hex(args)
+    if not args.no_build:
+        env = dict(os.environ, PEBBLE_SAYS_BENCH_REPLAY=hex_data)
+        env.pop('PEBBLE_SAYS_RELEASE', None)
+        env.pop('PEBBLE_SAYS_LEAN_APLITE', None)
+        subprocess.check_call(['pebble', 'build'], cwd=ROOT, env=env)
+
+    out_dir = args.out or os.path.join(ROOT, 'build', 'bench', build_label())
+    os.makedirs(out_dir, exist_ok=True)
+    summary = ['{:<9}'.format('platform') + ''.join(' {:>14}'.format('{}.{}'.format(*c)) for c in SUMMARY)]
+    failed = False
+    for platform in args.platforms:
+        print('== {}'.format(platform), flush=True)
+        lines = run_platform(platform, args.timeout)
+        if lines is None or lines[-1] != 'done':
+            print('{}: {}'.format(platform, 'timed out' if lines is None else lines[-1]), file=sys.stderr)
+            failed = True
+            lines = lines or []
+        if any('DIVERGED' in line for line in lines):
+            print('{}: playback diverged from the recording'.format(platform), file=sys.stderr)
+            failed = True
+        with open(os.path.join(out_dir, platform + '.txt'), 'w') as f:
+            f.write('platform {}\n'.format(platform))
+            f.write(''.join(line + '\n' for line in lines))
+        summary.append('{:<9}'.format(platform) +
+                       ''.join(' {:>14}'.format(field(lines, *c)) for c in SUMMARY))
+
+    with open(os.path.join(out_dir, 'summary.txt'), 'w') as f:
+        f.write('\n'.join(summary) + '\n')
+    print('\n'.join(summary))
+    print('reports in {}'.format(out_dir))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())